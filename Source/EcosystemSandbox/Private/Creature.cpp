@@ -1,17 +1,23 @@
 #include "Creature.h"
 #include "CreatureAIController.h"
-#include "DynamicWeatherSystem.h"
+#include "CreatureSimulationSubsystem.h"
+#include "CreatureSignificanceSubsystem.h"
+#include "EcosystemClockSubsystem.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Engine/Engine.h"
 #include "Materials/MaterialInstanceDynamic.h"
-#include "Kismet/GameplayStatics.h"
+#include "Perception/AIPerceptionSystem.h"
+#include "Perception/AISense_Sight.h"
+#include "TimerManager.h"
+#include "CreaturePoolSubsystem.h"
 
 ACreature::ACreature()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Life stats are stepped in bulk by UCreatureSimulationSubsystem
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Setup interaction sphere
 	InteractionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("InteractionSphere"));
@@ -44,55 +50,134 @@ void ACreature::BeginPlay()
 
 	CreatureAI = Cast<ACreatureAIController>(GetController());
 
-	// Find weather system
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ADynamicWeatherSystem::StaticClass(), FoundActors);
-	if (FoundActors.Num() > 0)
-	{
-		WeatherSystem = Cast<ADynamicWeatherSystem>(FoundActors[0]);
-	}
-
 	// Bind overlap events
 	InteractionSphere->OnComponentBeginOverlap.AddDynamic(this, &ACreature::OnInteractionSphereBeginOverlap);
 
-	// Apply genetic traits
+	// Apply genetic traits, genes set in the editor have not been evaluated yet
+	Evaluation = FGenomeEvaluation::Evaluate(Genes);
 	ApplyGeneticTraits();
 	UpdateAppearance();
 	UpdateMovementParameters();
+	StartSimulation();
+	StartSignificance();
 }
 
-void ACreature::Tick(float DeltaTime)
+void ACreature::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (Simulation)
+	{
+		Simulation->Unregister(this);
+	}
+
+	if (Significance)
+	{
+		Significance->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
-	UpdateLifeStats(DeltaTime);
-	UpdateWeatherEffects(DeltaTime);
+void ACreature::StartSimulation()
+{
+	if (Simulation)
+	{
+		Simulation->SetRates(this, Evaluation.Rates);
+		return;
+	}
 
-	// Check if creature should die
-	if (Health <= 0.0f || Age >= Genes.LifeSpan)
+	if (UCreatureSimulationSubsystem* Subsystem = GetWorld()->GetSubsystem<UCreatureSimulationSubsystem>())
 	{
-		Die();
+		Subsystem->Register(this, GetLifeState(), Evaluation.Rates);
+	}
+}
+
+void ACreature::StartSignificance()
+{
+	if (Significance)
+	{
+		return;
+	}
+
+	if (UCreatureSignificanceSubsystem* Subsystem = GetWorld()->GetSubsystem<UCreatureSignificanceSubsystem>())
+	{
+		Subsystem->Register(this);
+	}
+}
+
+void ACreature::SetTickInterval(float TickInterval)
+{
+	// Interval ticks are passed the time since their last tick, so nothing here accumulates DeltaTime itself
+	SetActorTickInterval(TickInterval);
+	ForEachComponent<UActorComponent>(false, [TickInterval](UActorComponent* Component)
+	{
+		if (Component->PrimaryComponentTick.bCanEverTick)
+		{
+			Component->SetComponentTickInterval(TickInterval);
+		}
+	});
+
+	if (CreatureAI)
+	{
+		CreatureAI->SetTickInterval(TickInterval);
+	}
+}
+
+void ACreature::SetHibernating(bool bHibernate)
+{
+	if (!Simulation)
+	{
+		return;
+	}
+
+	if (bHibernate)
+	{
+		Simulation->Hibernate(this);
+	}
+	else
+	{
+		Simulation->Wake(this);
 	}
+}
+
+void ACreature::NoteInteraction()
+{
+	LastInteractionTime = GetWorld()->GetTimeSeconds();
+
+	if (Significance)
+	{
+		Significance->NotifyInteraction(this);
+	}
+}
+
+void ACreature::NotifyLifeStatsChanged(bool bCanReproduce)
+{
+	// Mirror the simulated stats into the properties, then tell the behavior tree
+	SetLifeState(GetLifeState());
 
-	// Update AI with current stats
 	if (CreatureAI)
 	{
-		CreatureAI->UpdateStats(Energy, Hunger, CanReproduce());
+		CreatureAI->UpdateStats(Energy, Hunger, bCanReproduce);
 	}
 }
 
 bool ACreature::CanReproduce() const
 {
-	return Age >= MaturityAge && 
-		   Energy > 50.0f && 
-		   Hunger < 70.0f && 
-		   ReproductionCooldown <= 0.0f &&
-		   Health > 30.0f;
+	return FCreatureMetabolism::CanReproduce(GetLifeState(), Evaluation.Rates);
 }
 
 float ACreature::CalculateFitnessScore() const
 {
-	return Genes.CalculateFitness(Age, OffspringCount, ResourcesGathered, CombatWins);
+	return FMath::Max(0.0f, CalculateRawFitnessScore());
+}
+
+float ACreature::CalculateRawFitnessScore() const
+{
+	return Evaluation.GetRawFitness(GetAge(), OffspringCount, ResourcesGathered, CombatWins);
+}
+
+float ACreature::GetFitnessRate() const
+{
+	return Evaluation.Rates.AgingRate * Evaluation.SurvivalFitnessRate;
 }
 
 void ACreature::SetCreatureState(ECreatureState NewState)
@@ -107,11 +192,71 @@ void ACreature::SetCreatureState(ECreatureState NewState)
 }
 
 void ACreature::InitializeWithGenes(const FCreatureGenes& NewGenes)
+{
+	InitializeWithEvaluatedGenes(NewGenes, FGenomeEvaluation::Evaluate(NewGenes));
+}
+
+void ACreature::InitializeWithEvaluatedGenes(const FCreatureGenes& NewGenes, const FGenomeEvaluation& NewEvaluation)
 {
 	Genes = NewGenes;
+	Evaluation = NewEvaluation;
 	ApplyGeneticTraits();
 	UpdateAppearance();
 	UpdateMovementParameters();
+
+	// Creatures spawned into a running world have begun play already, BeginPlay registers the others
+	if (HasActorBegunPlay())
+	{
+		StartSimulation();
+	}
+}
+
+void ACreature::InitializeRandomStream(int32 NewCreatureId, const FSimulationRandomStream& NewStream)
+{
+	CreatureId = NewCreatureId;
+	RandomStream = NewStream;
+}
+
+FCreatureLifeState ACreature::GetLifeState() const
+{
+	FCreatureLifeState State;
+	State.Energy = Energy;
+	State.Hunger = Hunger;
+	State.Age = Age;
+	State.Health = Health;
+	State.ReproductionCooldown = ReproductionCooldown;
+	State.ResourcesGathered = ResourcesGathered;
+	State.OffspringCount = OffspringCount;
+	State.CombatWins = CombatWins;
+
+	if (Simulation)
+	{
+		Simulation->GetState(this, State);
+	}
+	return State;
+}
+
+void ACreature::RestoreLifeState(const FCreatureLifeState& State)
+{
+	SetLifeState(State);
+	OnFitnessChanged.Broadcast(this);
+}
+
+void ACreature::SetLifeState(const FCreatureLifeState& State)
+{
+	Energy = State.Energy;
+	Hunger = State.Hunger;
+	Age = State.Age;
+	Health = State.Health;
+	ReproductionCooldown = State.ReproductionCooldown;
+	ResourcesGathered = State.ResourcesGathered;
+	OffspringCount = State.OffspringCount;
+	CombatWins = State.CombatWins;
+
+	if (Simulation)
+	{
+		Simulation->SetState(this, State);
+	}
 }
 
 bool ACreature::AttemptReproduction(ACreature* Mate)
@@ -122,31 +267,36 @@ bool ACreature::AttemptReproduction(ACreature* Mate)
 	}
 
 	// Create offspring genes
-	FCreatureGenes OffspringGenes = FCreatureGenes::Crossover(Genes, Mate->Genes);
-	OffspringGenes.Mutate(0.1f, 0.2f);
+	FCreatureGenes OffspringGenes = FCreatureGenes::Crossover(Genes, Mate->Genes, RandomStream);
+	OffspringGenes.Mutate(RandomStream, 0.1f, 0.2f);
 
 	// Broadcast reproduction event
 	OnCreatureReproduction.Broadcast(this, Mate, OffspringGenes);
 
-	// Apply reproduction cost
-	Energy -= 30.0f;
-	Mate->Energy -= 30.0f;
+	// Apply reproduction cost, cooldown and offspring count
+	FCreatureLifeState State = GetLifeState();
+	FCreatureMetabolism::ApplyReproductionCost(State, Genes.ReproductionRate);
+	SetLifeState(State);
 
-	// Set cooldown
-	ReproductionCooldown = 20.0f / Genes.ReproductionRate;
-	Mate->ReproductionCooldown = 20.0f / Mate->Genes.ReproductionRate;
+	FCreatureLifeState MateState = Mate->GetLifeState();
+	FCreatureMetabolism::ApplyReproductionCost(MateState, Mate->Genes.ReproductionRate);
+	Mate->SetLifeState(MateState);
 
-	// Increase offspring count
-	OffspringCount++;
-	Mate->OffspringCount++;
+	NoteInteraction();
+	Mate->NoteInteraction();
+
+	OnFitnessChanged.Broadcast(this);
+	Mate->OnFitnessChanged.Broadcast(Mate);
 
 	return true;
 }
 
 void ACreature::TakeDamage(float DamageAmount, ACreature* Attacker)
 {
-	float ActualDamage = DamageAmount / Genes.DamageResistance;
-	Health = FMath::Max(0.0f, Health - ActualDamage);
+	FCreatureLifeState State = GetLifeState();
+	float ActualDamage = FCreatureMetabolism::ApplyDamage(State, DamageAmount, Genes.DamageResistance);
+	SetLifeState(State);
+	NoteInteraction();
 
 	// Apply physics impulse for impact
 	if (GetMesh() && Attacker)
@@ -156,21 +306,25 @@ void ACreature::TakeDamage(float DamageAmount, ACreature* Attacker)
 		GetMesh()->AddImpulse(ImpulseDirection * ImpulseStrength);
 	}
 
-	if (Health <= 0.0f)
+	if (State.Health <= 0.0f)
 	{
 		Die();
 		if (Attacker)
 		{
 			Attacker->CombatWins++;
+			Attacker->OnFitnessChanged.Broadcast(Attacker);
 		}
 	}
 }
 
 void ACreature::ConsumeFood(float FoodValue)
 {
-	Energy = FMath::Min(100.0f, Energy + FoodValue);
-	Hunger = FMath::Max(0.0f, Hunger - FoodValue * 0.5f);
-	ResourcesGathered += FoodValue;
+	FCreatureLifeState State = GetLifeState();
+	FCreatureMetabolism::ConsumeFood(State, FoodValue);
+	SetLifeState(State);
+	NoteInteraction();
+
+	OnFitnessChanged.Broadcast(this);
 }
 
 void ACreature::Attack(ACreature* Target)
@@ -180,7 +334,7 @@ void ACreature::Attack(ACreature* Target)
 		return;
 	}
 
-	float CurrentTime = GetWorld()->GetTimeSeconds();
+	const double CurrentTime = UEcosystemClockSubsystem::GetSimulationSeconds(GetWorld());
 	if (CurrentTime - LastAttackTime < 1.0f)
 	{
 		return;
@@ -198,54 +352,134 @@ void ACreature::Attack(ACreature* Target)
 		Target->GetMesh()->AddImpulse(AttackDirection * Genes.Strength * 500.0f);
 	}
 
-	Energy -= 5.0f;
+	FCreatureLifeState State = GetLifeState();
+	State.Energy -= 5.0f;
+	SetLifeState(State);
 }
 
 void ACreature::Die()
 {
+	// The dying are no longer simulated, their final stats stay on the actor
+	if (Simulation)
+	{
+		Simulation->Unregister(this);
+	}
+
+	// Death has already been reported
+	if (CurrentState == ECreatureState::Dying)
+	{
+		return;
+	}
+
 	SetCreatureState(ECreatureState::Dying);
 	
 	float FitnessScore = CalculateFitnessScore();
 	OnCreatureDeath.Broadcast(this, FitnessScore);
 
 	// Disable AI
-	if (CreatureAI)
+	if (CreatureAI && CreatureAI->GetBrainComponent())
 	{
 		CreatureAI->GetBrainComponent()->StopLogic(TEXT("Death"));
 	}
 
-	// Schedule destruction
-	SetLifeSpan(2.0f);
+	// Schedule return to the pool
+	GetWorldTimerManager().SetTimer(PoolReleaseTimer, this, &ACreature::ReturnToPool, 2.0f);
 }
 
-void ACreature::UpdateLifeStats(float DeltaTime)
+void ACreature::ReturnToPool()
 {
-	// Age the creature
-	Age += DeltaTime * AgingRate;
+	if (UCreaturePoolSubsystem* Pool = GetWorld()->GetSubsystem<UCreaturePoolSubsystem>())
+	{
+		Pool->ReleaseCreature(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void ACreature::DeactivateForPool()
+{
+	bPooled = true;
+	GetWorldTimerManager().ClearTimer(PoolReleaseTimer);
+
+	if (Simulation)
+	{
+		Simulation->Unregister(this);
+	}
+
+	if (Significance)
+	{
+		Significance->Unregister(this);
+	}
 
-	// Energy decay
-	float EnergyDecay = EnergyDecayRate * DeltaTime;
-	Energy = FMath::Max(0.0f, Energy - EnergyDecay);
+	// Listeners bind again when the creature is handed out
+	OnCreatureDeath.Clear();
+	OnCreatureReproduction.Clear();
+	OnFitnessChanged.Clear();
 
-	// Hunger growth
-	float HungerGrowth = HungerGrowthRate * DeltaTime / Genes.HungerResistance;
-	Hunger = FMath::Min(100.0f, Hunger + HungerGrowth);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	GetMesh()->SetSimulatePhysics(false);
 
-	// Reduce reproduction cooldown
-	if (ReproductionCooldown > 0.0f)
+	if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
 	{
-		ReproductionCooldown -= DeltaTime;
+		MovementComp->StopMovementImmediately();
+		MovementComp->Deactivate();
 	}
 
-	// Health effects
-	if (Energy <= 0.0f || Hunger >= 90.0f)
+	if (CreatureAI)
+	{
+		CreatureAI->DeactivateForPool();
+	}
+
+	// Hidden creatures must not be seen by others
+	if (UAIPerceptionSystem* PerceptionSystem = UAIPerceptionSystem::GetCurrent(GetWorld()))
+	{
+		PerceptionSystem->UnregisterSource(*this);
+	}
+}
+
+void ACreature::ResetForReuse(const FTransform& Transform)
+{
+	bPooled = false;
+
+	// Put the physics mesh back under the capsule before moving
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// Reset life stats
+	Energy = 100.0f;
+	Hunger = 0.0f;
+	Age = 0.0f;
+	Health = 100.0f;
+	CurrentState = ECreatureState::Idle;
+	ReproductionCooldown = 0.0f;
+	OffspringCount = 0;
+	CombatWins = 0;
+	LastAttackTime = 0.0;
+	LastInteractionTime = TNumericLimits<float>::Lowest();
+	ResourcesGathered = 0.0f;
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	GetMesh()->SetSimulatePhysics(true);
+
+	// Movement mode is set again from the new genes
+	if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
 	{
-		Health -= 10.0f * DeltaTime;
+		MovementComp->Activate(true);
+		MovementComp->SetMovementMode(MOVE_Walking);
 	}
-	else if (Energy > 70.0f && Hunger < 30.0f)
+
+	if (CreatureAI)
 	{
-		Health = FMath::Min(100.0f, Health + 5.0f * DeltaTime);
+		CreatureAI->ResetForReuse();
 	}
+
+	UAIPerceptionSystem::RegisterPerceptionStimuliSource(this, UAISense_Sight::StaticClass(), this);
+	StartSignificance();
 }
 
 void ACreature::UpdateAppearance()
@@ -255,12 +489,16 @@ void ACreature::UpdateAppearance()
 		return;
 	}
 
-	// Create dynamic material instance
-	UMaterialInstanceDynamic* DynamicMaterial = BodyMesh->CreateAndSetMaterialInstanceDynamic(0);
-	if (DynamicMaterial)
+	// Create dynamic material instance once
+	if (!BodyMaterial)
 	{
-		DynamicMaterial->SetVectorParameterValue(TEXT("PrimaryColor"), Genes.PrimaryColor);
-		DynamicMaterial->SetVectorParameterValue(TEXT("SecondaryColor"), Genes.SecondaryColor);
+		BodyMaterial = BodyMesh->CreateAndSetMaterialInstanceDynamic(0);
+	}
+
+	if (BodyMaterial)
+	{
+		BodyMaterial->SetVectorParameterValue(TEXT("PrimaryColor"), Genes.PrimaryColor);
+		BodyMaterial->SetVectorParameterValue(TEXT("SecondaryColor"), Genes.SecondaryColor);
 	}
 
 	// Scale creature based on size gene
@@ -283,7 +521,7 @@ void ACreature::UpdateMovementParameters()
 	}
 
 	// Update movement based on genes
-	MovementComp->MaxWalkSpeed = Genes.Speed * 200.0f;
+	MovementComp->MaxWalkSpeed = Genes.Speed * 200.0f * MovementModifier;
 	MovementComp->JumpZVelocity = Genes.Strength * 400.0f;
 	MovementComp->Mass = Genes.Size * 100.0f;
 
@@ -310,10 +548,7 @@ void ACreature::UpdateMovementParameters()
 void ACreature::ApplyGeneticTraits()
 {
 	// Update life parameters based on genes
-	EnergyDecayRate = 2.0f / Genes.Endurance;
-	HungerGrowthRate = 2.0f / Genes.HungerResistance;
-	AgingRate = 1.0f / Genes.LifeSpan * 100.0f;
-	MaturityAge = Genes.LifeSpan * 0.2f;
+	MaturityAge = Evaluation.Rates.MaturityAge;
 
 	// Update AI perception range
 	if (CreatureAI && CreatureAI->GetAIPerceptionComponent())
@@ -331,12 +566,14 @@ void ACreature::OnInteractionSphereBeginOverlap(UPrimitiveComponent* OverlappedC
 		return;
 	}
 
+	NoteInteraction();
+
 	// Handle creature interactions based on aggression and state
 	switch (Genes.AggressionLevel)
 	{
 		case EAggressionLevel::Aggressive:
 		case EAggressionLevel::Predatory:
-			if (CurrentState != ECreatureState::Mating && Energy > 30.0f)
+			if (CurrentState != ECreatureState::Mating && GetEnergy() > 30.0f)
 			{
 				SetCreatureState(ECreatureState::Fighting);
 				Attack(OtherCreature);
@@ -362,49 +599,12 @@ void ACreature::OnInteractionSphereBeginOverlap(UPrimitiveComponent* OverlappedC
 	}
 }
 
-void ACreature::UpdateWeatherEffects(float DeltaTime)
+void ACreature::SetMovementModifier(float Modifier)
 {
-	if (!WeatherSystem)
-	{
-		return;
-	}
-
-	// Get weather effects
-	float TemperatureEffect = WeatherSystem->GetTemperatureEffect();
-	float VisibilityModifier = WeatherSystem->GetVisibilityModifier();
-	float MovementModifier = WeatherSystem->GetMovementModifier();
-
-	// Apply temperature effects on energy consumption
-	float TemperatureStress = FMath::Abs(TemperatureEffect - 0.5f) * 2.0f; // 0 to 1 scale
-	float AdditionalEnergyDecay = TemperatureStress * 0.5f * DeltaTime;
-	Energy = FMath::Max(0.0f, Energy - AdditionalEnergyDecay);
+	MovementModifier = Modifier;
 
-	// Apply movement modifier to character movement
-	UCharacterMovementComponent* MovementComp = GetCharacterMovement();
-	if (MovementComp)
+	if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
 	{
-		float BaseSpeed = Genes.Speed * 200.0f;
-		MovementComp->MaxWalkSpeed = BaseSpeed * MovementModifier;
-	}
-
-	// Apply visibility effects to AI perception
-	if (CreatureAI && CreatureAI->GetAIPerceptionComponent())
-	{
-		// Reduce perception range in bad weather
-		// This would require updating sight config at runtime
-		// For now, we'll affect the creature's behavior through energy
-		if (VisibilityModifier < 0.5f)
-		{
-			Energy -= 0.2f * DeltaTime; // Extra energy cost in poor visibility
-		}
-	}
-
-	// Weather affects health regeneration
-	if (TemperatureEffect > 0.3f && TemperatureEffect < 0.8f) // Comfortable temperature range
-	{
-		if (Energy > 70.0f && Hunger < 30.0f)
-		{
-			Health = FMath::Min(100.0f, Health + 6.0f * DeltaTime); // Faster healing in good weather
-		}
+		MovementComp->MaxWalkSpeed = Genes.Speed * 200.0f * MovementModifier;
 	}
 }
@@ -35,19 +35,6 @@ void ACreatureAIController::BeginPlay()
 	}
 }
 
-void ACreatureAIController::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	// Update blackboard with creature stats
-	if (ControlledCreature && BlackboardComponent)
-	{
-		BlackboardComponent->SetValueAsFloat(EnergyKey, ControlledCreature->GetEnergy());
-		BlackboardComponent->SetValueAsFloat(HungerKey, ControlledCreature->GetHunger());
-		BlackboardComponent->SetValueAsBool(CanReproduceKey, ControlledCreature->CanReproduce());
-	}
-}
-
 void ACreatureAIController::SetTargetActor(AActor* NewTarget)
 {
 	if (BlackboardComponent)
@@ -82,6 +69,61 @@ void ACreatureAIController::UpdateStats(float Energy, float Hunger, bool bCanRep
 	}
 }
 
+void ACreatureAIController::SetTickInterval(float TickInterval)
+{
+	// Covers the behavior tree and path following along with the controller itself
+	SetActorTickInterval(TickInterval);
+	ForEachComponent<UActorComponent>(false, [TickInterval](UActorComponent* Component)
+	{
+		if (Component->PrimaryComponentTick.bCanEverTick)
+		{
+			Component->SetComponentTickInterval(TickInterval);
+		}
+	});
+}
+
+void ACreatureAIController::DeactivateForPool()
+{
+	StopMovement();
+
+	if (BrainComponent)
+	{
+		BrainComponent->StopLogic(TEXT("Pooled"));
+	}
+
+	if (AIPerceptionComponent)
+	{
+		AIPerceptionComponent->ForgetAll();
+		AIPerceptionComponent->Deactivate();
+	}
+
+	SetActorTickEnabled(false);
+}
+
+void ACreatureAIController::ResetForReuse()
+{
+	SetActorTickEnabled(true);
+
+	if (AIPerceptionComponent)
+	{
+		AIPerceptionComponent->Activate(true);
+	}
+
+	// Forget targets from the previous life
+	if (BlackboardComponent)
+	{
+		BlackboardComponent->ClearValue(TargetActorKey);
+		BlackboardComponent->ClearValue(TargetLocationKey);
+		BlackboardComponent->ClearValue(StateKey);
+	}
+
+	// Restarts the tree from the root
+	if (BehaviorTree)
+	{
+		RunBehaviorTree(BehaviorTree);
+	}
+}
+
 void ACreatureAIController::OnPerceptionUpdated(const TArray<AActor*>& UpdatedActors)
 {
 	if (!ControlledCreature || !BlackboardComponent)
@@ -1,105 +1,113 @@
 #include "CreatureGenetics.h"
+#include "PackedGenome.h"
+#include "GeneTraits.h"
 #include "Math/UnrealMathUtility.h"
 
-void FCreatureGenes::Mutate(float MutationRate, float MutationStrength)
+void FCreatureGenes::Mutate(FSimulationRandomStream& Stream, float MutationRate, float MutationStrength)
 {
-	auto MutateFloat = [&](float& Value, float Min, float Max)
+	FGeneTraits::ForEach([&](auto Trait)
 	{
-		if (FMath::RandRange(0.0f, 1.0f) < MutationRate)
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[decltype(Trait)::Value];
+		if (Stream.GetFraction() < MutationRate)
 		{
-			float Change = FMath::RandRange(-MutationStrength, MutationStrength);
-			Value = FMath::Clamp(Value + Change, Min, Max);
+			const float Strength = MutationStrength * Descriptor.MutationScale;
+			float& Value = this->*Descriptor.Member;
+			Value = FMath::Clamp(Value + Stream.FRandRange(-Strength, Strength), Descriptor.Min, Descriptor.Max);
 		}
-	};
+	});
 
-	auto MutateEnum = [&](auto& EnumValue, int32 MaxValue)
+	if (Stream.GetFraction() < MutationRate)
 	{
-		if (FMath::RandRange(0.0f, 1.0f) < MutationRate)
-		{
-			EnumValue = static_cast<decltype(EnumValue)>(FMath::RandRange(0, MaxValue));
-		}
-	};
-
-	// Mutate physical traits
-	MutateFloat(Size, 0.1f, 5.0f);
-	MutateFloat(Speed, 0.1f, 10.0f);
-	MutateFloat(Strength, 0.1f, 3.0f);
-	MutateFloat(Endurance, 0.1f, 2.0f);
+		MovementType = static_cast<EMovementType>(Stream.RandRange(0, static_cast<int32>(EMovementType::Count) - 1));
+	}
+	if (Stream.GetFraction() < MutationRate)
+	{
+		AggressionLevel = static_cast<EAggressionLevel>(Stream.RandRange(0, static_cast<int32>(EAggressionLevel::Count) - 1));
+	}
 
-	// Mutate behavioral traits
-	MutateEnum(MovementType, 4);
-	MutateEnum(AggressionLevel, 4);
-	MutateFloat(ReproductionRate, 0.01f, 1.0f);
-	MutateFloat(LifeSpan, 1.0f, 100.0f);
+	// Mutate colors
+	if (Stream.GetFraction() < MutationRate)
+	{
+		PrimaryColor = Stream.MakeRandomColor();
+	}
+	if (Stream.GetFraction() < MutationRate)
+	{
+		SecondaryColor = Stream.MakeRandomColor();
+	}
+}
 
-	// Mutate intelligence traits
-	MutateFloat(Intelligence, 0.1f, 3.0f);
-	MutateFloat(VisionRange, 100.0f, 2000.0f);
-	MutateFloat(SocialTendency, 0.1f, 2.0f);
+void FCreatureGenes::MutateSelfAdaptive(FSimulationRandomStream& Stream, float MutationRate)
+{
+	// Mutate the step size first, so it is judged by the offspring it produces
+	MutationStepSize = FMath::Clamp(MutationStepSize * FMath::Exp(GetStepSizeLearningRate() * Stream.GetGaussian()), MinStepSize, MaxStepSize);
 
-	// Mutate survival traits
-	MutateFloat(HungerResistance, 0.1f, 3.0f);
-	MutateFloat(DamageResistance, 0.1f, 3.0f);
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[decltype(Trait)::Value];
+		float& Value = this->*Descriptor.Member;
+		Value = Descriptor.Reflect(Value + MutationStepSize * Descriptor.GetRange() * Stream.GetGaussian());
+	});
 
-	// Mutate colors
-	if (FMath::RandRange(0.0f, 1.0f) < MutationRate)
+	if (Stream.GetFraction() < MutationRate)
+	{
+		MovementType = static_cast<EMovementType>(Stream.RandRange(0, static_cast<int32>(EMovementType::Count) - 1));
+	}
+	if (Stream.GetFraction() < MutationRate)
+	{
+		AggressionLevel = static_cast<EAggressionLevel>(Stream.RandRange(0, static_cast<int32>(EAggressionLevel::Count) - 1));
+	}
+	if (Stream.GetFraction() < MutationRate)
 	{
-		PrimaryColor = FLinearColor::MakeRandomColor();
+		PrimaryColor = Stream.MakeRandomColor();
 	}
-	if (FMath::RandRange(0.0f, 1.0f) < MutationRate)
+	if (Stream.GetFraction() < MutationRate)
 	{
-		SecondaryColor = FLinearColor::MakeRandomColor();
+		SecondaryColor = Stream.MakeRandomColor();
 	}
 }
 
-FCreatureGenes FCreatureGenes::Crossover(const FCreatureGenes& Parent1, const FCreatureGenes& Parent2)
+float FCreatureGenes::GetStepSizeLearningRate()
+{
+	return 1.0f / FMath::Sqrt(static_cast<float>(FGeneTraits::Num));
+}
+
+FCreatureGenes FCreatureGenes::Crossover(const FCreatureGenes& Parent1, const FCreatureGenes& Parent2, FSimulationRandomStream& Stream)
 {
 	FCreatureGenes Offspring;
 
-	auto BlendFloat = [](float A, float B) -> float
+	FGeneTraits::ForEach([&](auto Trait)
 	{
-		return FMath::RandRange(0.0f, 1.0f) < 0.5f ? A : B;
-	};
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[decltype(Trait)::Value];
+		Offspring.*Descriptor.Member = Stream.GetFraction() < 0.5f ? Parent1.*Descriptor.Member : Parent2.*Descriptor.Member;
+	});
 
-	auto BlendEnum = [](auto A, auto B) -> decltype(A)
-	{
-		return FMath::RandRange(0.0f, 1.0f) < 0.5f ? A : B;
-	};
-
-	// Blend physical traits
-	Offspring.Size = BlendFloat(Parent1.Size, Parent2.Size);
-	Offspring.Speed = BlendFloat(Parent1.Speed, Parent2.Speed);
-	Offspring.Strength = BlendFloat(Parent1.Strength, Parent2.Strength);
-	Offspring.Endurance = BlendFloat(Parent1.Endurance, Parent2.Endurance);
-
-	// Blend behavioral traits
-	Offspring.MovementType = BlendEnum(Parent1.MovementType, Parent2.MovementType);
-	Offspring.AggressionLevel = BlendEnum(Parent1.AggressionLevel, Parent2.AggressionLevel);
-	Offspring.ReproductionRate = BlendFloat(Parent1.ReproductionRate, Parent2.ReproductionRate);
-	Offspring.LifeSpan = BlendFloat(Parent1.LifeSpan, Parent2.LifeSpan);
-
-	// Blend intelligence traits
-	Offspring.Intelligence = BlendFloat(Parent1.Intelligence, Parent2.Intelligence);
-	Offspring.VisionRange = BlendFloat(Parent1.VisionRange, Parent2.VisionRange);
-	Offspring.SocialTendency = BlendFloat(Parent1.SocialTendency, Parent2.SocialTendency);
-
-	// Blend survival traits
-	Offspring.HungerResistance = BlendFloat(Parent1.HungerResistance, Parent2.HungerResistance);
-	Offspring.DamageResistance = BlendFloat(Parent1.DamageResistance, Parent2.DamageResistance);
+	Offspring.MovementType = Stream.GetFraction() < 0.5f ? Parent1.MovementType : Parent2.MovementType;
+	Offspring.AggressionLevel = Stream.GetFraction() < 0.5f ? Parent1.AggressionLevel : Parent2.AggressionLevel;
 
 	// Blend colors
-	Offspring.PrimaryColor = FMath::RandRange(0.0f, 1.0f) < 0.5f ? Parent1.PrimaryColor : Parent2.PrimaryColor;
-	Offspring.SecondaryColor = FMath::RandRange(0.0f, 1.0f) < 0.5f ? Parent1.SecondaryColor : Parent2.SecondaryColor;
+	Offspring.PrimaryColor = Stream.GetFraction() < 0.5f ? Parent1.PrimaryColor : Parent2.PrimaryColor;
+	Offspring.SecondaryColor = Stream.GetFraction() < 0.5f ? Parent1.SecondaryColor : Parent2.SecondaryColor;
+
+	// Step sizes are averaged on a log scale
+	Offspring.MutationStepSize = FMath::Sqrt(Parent1.MutationStepSize * Parent2.MutationStepSize);
 
 	return Offspring;
 }
 
 float FCreatureGenes::CalculateFitness(float Age, int32 OffspringCount, float ResourcesGathered, int32 CombatWins) const
 {
-	float Fitness = 0.0f;
+	return FMath::Max(0.0f, CalculateRawFitness(Age, OffspringCount, ResourcesGathered, CombatWins));
+}
 
+float FCreatureGenes::CalculateRawFitness(float Age, int32 OffspringCount, float ResourcesGathered, int32 CombatWins) const
+{
 	// Survival bonus (lived longer = better)
-	Fitness += Age / LifeSpan * 100.0f;
+	return Age * GetSurvivalFitnessRate() + CalculateAchievementFitness(OffspringCount, ResourcesGathered, CombatWins) + CalculateTraitFitness();
+}
+
+float FCreatureGenes::CalculateAchievementFitness(int32 OffspringCount, float ResourcesGathered, int32 CombatWins)
+{
+	float Fitness = 0.0f;
 
 	// Reproduction success (more offspring = better)
 	Fitness += OffspringCount * 50.0f;
@@ -110,6 +118,13 @@ float FCreatureGenes::CalculateFitness(float Age, int32 OffspringCount, float Re
 	// Combat effectiveness
 	Fitness += CombatWins * 25.0f;
 
+	return Fitness;
+}
+
+float FCreatureGenes::CalculateTraitFitness() const
+{
+	float Fitness = 0.0f;
+
 	// Size efficiency (not too big, not too small)
 	float SizeOptimal = FMath::Abs(Size - 1.0f);
 	Fitness += (1.0f - SizeOptimal) * 20.0f;
@@ -120,32 +135,42 @@ float FCreatureGenes::CalculateFitness(float Age, int32 OffspringCount, float Re
 	// Endurance bonus
 	Fitness += Endurance * 10.0f;
 
-	return FMath::Max(0.0f, Fitness);
+	return Fitness;
 }
 
-FCreatureGenes FCreatureGenes::GenerateRandom()
+FCreatureGenes FCreatureGenes::GenerateRandom(FSimulationRandomStream& Stream)
 {
 	FCreatureGenes RandomGenes;
 
-	RandomGenes.Size = FMath::RandRange(0.1f, 5.0f);
-	RandomGenes.Speed = FMath::RandRange(0.1f, 10.0f);
-	RandomGenes.Strength = FMath::RandRange(0.1f, 3.0f);
-	RandomGenes.Endurance = FMath::RandRange(0.1f, 2.0f);
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[decltype(Trait)::Value];
+		RandomGenes.*Descriptor.Member = Stream.FRandRange(Descriptor.Min, Descriptor.Max);
+	});
 
-	RandomGenes.MovementType = static_cast<EMovementType>(FMath::RandRange(0, 4));
-	RandomGenes.AggressionLevel = static_cast<EAggressionLevel>(FMath::RandRange(0, 4));
-	RandomGenes.ReproductionRate = FMath::RandRange(0.01f, 1.0f);
-	RandomGenes.LifeSpan = FMath::RandRange(1.0f, 100.0f);
+	RandomGenes.MovementType = static_cast<EMovementType>(Stream.RandRange(0, static_cast<int32>(EMovementType::Count) - 1));
+	RandomGenes.AggressionLevel = static_cast<EAggressionLevel>(Stream.RandRange(0, static_cast<int32>(EAggressionLevel::Count) - 1));
 
-	RandomGenes.Intelligence = FMath::RandRange(0.1f, 3.0f);
-	RandomGenes.VisionRange = FMath::RandRange(100.0f, 2000.0f);
-	RandomGenes.SocialTendency = FMath::RandRange(0.1f, 2.0f);
+	RandomGenes.PrimaryColor = Stream.MakeRandomColor();
+	RandomGenes.SecondaryColor = Stream.MakeRandomColor();
 
-	RandomGenes.HungerResistance = FMath::RandRange(0.1f, 3.0f);
-	RandomGenes.DamageResistance = FMath::RandRange(0.1f, 3.0f);
+	return RandomGenes;
+}
 
-	RandomGenes.PrimaryColor = FLinearColor::MakeRandomColor();
-	RandomGenes.SecondaryColor = FLinearColor::MakeRandomColor();
+bool FCreatureGenes::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	FPackedGenome Packed;
+	if (Ar.IsSaving())
+	{
+		Packed = FPackedGenome::Pack(*this);
+	}
 
-	return RandomGenes;
+	Packed.NetSerialize(Ar, Map, bOutSuccess);
+
+	if (Ar.IsLoading())
+	{
+		*this = Packed.Unpack();
+	}
+
+	return true;
 }
@@ -0,0 +1,229 @@
+#include "CreatureHistoryLog.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/Paths.h"
+
+FCreatureHistoryDiskRecord FCreatureHistoryDiskRecord::FromRecord(const FCreatureRecord& Record)
+{
+	FCreatureHistoryDiskRecord DiskRecord;
+	DiskRecord.Genome = FPackedGenome::Pack(Record.Genes);
+	DiskRecord.FitnessScore = Record.FitnessScore;
+	DiskRecord.LifeTime = Record.LifeTime;
+	DiskRecord.Generation = Record.Generation;
+	DiskRecord.OffspringCount = Record.OffspringCount;
+	return DiskRecord;
+}
+
+FCreatureRecord FCreatureHistoryDiskRecord::ToRecord() const
+{
+	FCreatureRecord Record;
+	Record.Genes = Genome.Unpack();
+	Record.FitnessScore = FitnessScore;
+	Record.LifeTime = LifeTime;
+	Record.Generation = Generation;
+	Record.OffspringCount = OffspringCount;
+	return Record;
+}
+
+FCreatureHistoryLog::~FCreatureHistoryLog()
+{
+	Close();
+}
+
+bool FCreatureHistoryLog::Open(const FString& InPath, int32 InRingCapacity, int32 InFlushBatchSize)
+{
+	Close();
+
+	Path = InPath;
+	RingCapacity = FMath::Max(1, InRingCapacity);
+	FlushBatchSize = FMath::Max(1, InFlushBatchSize);
+	Ring.Reset();
+	Ring.Reserve(RingCapacity);
+	RingHead = 0;
+	PendingWrites.Reset();
+	PendingWrites.Reserve(FlushBatchSize);
+	TotalRecords = 0;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+	FileHandle.Reset(PlatformFile.OpenWrite(*Path));
+
+	if (!FileHandle)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to open creature history log %s, only recent history will be kept"), *Path);
+		return false;
+	}
+
+	const FCreatureHistoryLogHeader Header;
+	FileHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	return true;
+}
+
+void FCreatureHistoryLog::Close()
+{
+	Flush();
+	FileHandle.Reset();
+}
+
+void FCreatureHistoryLog::Add(const FCreatureRecord& Record)
+{
+	// Packed once for both the ring and the file
+	const FCreatureHistoryDiskRecord DiskRecord = FCreatureHistoryDiskRecord::FromRecord(Record);
+
+	// Overwrite the oldest record once the ring is full
+	if (Ring.Num() < RingCapacity)
+	{
+		Ring.Add(DiskRecord);
+	}
+	else
+	{
+		Ring[RingHead] = DiskRecord;
+		RingHead = (RingHead + 1) % RingCapacity;
+	}
+
+	TotalRecords++;
+
+	if (FileHandle)
+	{
+		PendingWrites.Add(DiskRecord);
+		if (PendingWrites.Num() >= FlushBatchSize)
+		{
+			Flush();
+		}
+	}
+}
+
+void FCreatureHistoryLog::Flush()
+{
+	if (FileHandle && PendingWrites.Num() > 0)
+	{
+		FileHandle->Write(reinterpret_cast<const uint8*>(PendingWrites.GetData()), PendingWrites.Num() * sizeof(FCreatureHistoryDiskRecord));
+		FileHandle->Flush();
+	}
+
+	PendingWrites.Reset();
+}
+
+void FCreatureHistoryLog::Preload(TConstArrayView<FCreatureHistoryDiskRecord> Records)
+{
+	Ring.Reset();
+	RingHead = 0;
+
+	// Only the newest records fit
+	const int32 First = FMath::Max(0, Records.Num() - RingCapacity);
+	Ring.Append(Records.Slice(First, Records.Num() - First));
+}
+
+TArray<FCreatureRecord> FCreatureHistoryLog::GetRecent(int32 Count) const
+{
+	Count = FMath::Clamp(Count, 0, Ring.Num());
+
+	// RingHead is the oldest record once the ring has wrapped
+	TArray<FCreatureRecord> Records;
+	Records.Reserve(Count);
+	for (int32 i = Ring.Num() - Count; i < Ring.Num(); i++)
+	{
+		Records.Add(Ring[(RingHead + i) % Ring.Num()].ToRecord());
+	}
+
+	return Records;
+}
+
+FCreatureHistoryLogReader::~FCreatureHistoryLogReader()
+{
+	Close();
+}
+
+bool FCreatureHistoryLogReader::Open(const FString& InPath)
+{
+	Close();
+	Path = InPath;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const int64 FileSize = PlatformFile.FileSize(*Path);
+	if (FileSize < static_cast<int64>(sizeof(FCreatureHistoryLogHeader)))
+	{
+		return false;
+	}
+
+	FCreatureHistoryLogHeader Header;
+	TUniquePtr<IFileHandle> HeaderHandle(PlatformFile.OpenRead(*Path));
+	if (!HeaderHandle || !HeaderHandle->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header)))
+	{
+		return false;
+	}
+
+	if (Header.Magic != FCreatureHistoryLogHeader::ExpectedMagic || Header.Version != FCreatureHistoryLogHeader::CurrentVersion || Header.RecordSize != sizeof(FCreatureHistoryDiskRecord))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a compatible creature history log"), *Path);
+		return false;
+	}
+
+	// A partially written trailing record is ignored
+	NumRecords = (FileSize - sizeof(FCreatureHistoryLogHeader)) / sizeof(FCreatureHistoryDiskRecord);
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*Path));
+	if (MappedFile && NumRecords > 0)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(sizeof(FCreatureHistoryLogHeader), NumRecords * sizeof(FCreatureHistoryDiskRecord)));
+		if (MappedRegion)
+		{
+			MappedRecords = reinterpret_cast<const FCreatureHistoryDiskRecord*>(MappedRegion->GetMappedPtr());
+		}
+	}
+
+	return true;
+}
+
+void FCreatureHistoryLogReader::Close()
+{
+	// The region must go before the file it maps
+	MappedRecords = nullptr;
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	NumRecords = 0;
+}
+
+const FCreatureHistoryDiskRecord& FCreatureHistoryLogReader::GetDiskRecord(int64 Index) const
+{
+	check(MappedRecords && Index >= 0 && Index < NumRecords);
+	return MappedRecords[Index];
+}
+
+void FCreatureHistoryLogReader::ForEach(TFunctionRef<void(const FCreatureRecord&)> Visitor) const
+{
+	if (MappedRecords)
+	{
+		for (int64 i = 0; i < NumRecords; i++)
+		{
+			Visitor(MappedRecords[i].ToRecord());
+		}
+		return;
+	}
+
+	// Not mappable, stream the file in chunks
+	TUniquePtr<IFileHandle> FileHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+	if (!FileHandle || !FileHandle->Seek(sizeof(FCreatureHistoryLogHeader)))
+	{
+		return;
+	}
+
+	constexpr int64 ChunkRecords = 1024;
+	TArray<FCreatureHistoryDiskRecord> Chunk;
+	Chunk.SetNumUninitialized(ChunkRecords);
+
+	for (int64 Start = 0; Start < NumRecords; Start += ChunkRecords)
+	{
+		const int64 Count = FMath::Min(ChunkRecords, NumRecords - Start);
+		if (!FileHandle->Read(reinterpret_cast<uint8*>(Chunk.GetData()), Count * sizeof(FCreatureHistoryDiskRecord)))
+		{
+			return;
+		}
+
+		for (int64 i = 0; i < Count; i++)
+		{
+			Visitor(Chunk[i].ToRecord());
+		}
+	}
+}
@@ -0,0 +1,432 @@
+#include "CreatureMetabolism.h"
+#include "SimulationRandom.h"
+#include "HAL/IConsoleManager.h"
+
+#if INTEL_ISPC
+#include "CreatureMetabolism.ispc.generated.h"
+#endif
+
+#if !defined(CREATURE_METABOLISM_ISPC_ENABLED_DEFAULT)
+#define CREATURE_METABOLISM_ISPC_ENABLED_DEFAULT 1
+#endif
+
+// Shipping builds always take the ISPC path when the platform has it
+#if !INTEL_ISPC
+static constexpr bool bCreatureMetabolism_ISPC_Enabled = false;
+#elif UE_BUILD_SHIPPING
+static constexpr bool bCreatureMetabolism_ISPC_Enabled = true;
+#else
+static bool bCreatureMetabolism_ISPC_Enabled = CREATURE_METABOLISM_ISPC_ENABLED_DEFAULT;
+static FAutoConsoleVariableRef CVarCreatureMetabolismISPCEnabled(TEXT("Ecosystem.Metabolism.ISPC"), bCreatureMetabolism_ISPC_Enabled,
+	TEXT("Whether to step batched creature life stats with the ISPC kernels"));
+#endif
+
+namespace
+{
+	// Weather is the same for every creature, so its terms are worked out once per step
+	struct FWeatherTerms
+	{
+		float EnergyDecay;
+		float VisibilityCost;
+		bool bComfortable;
+		float Healing;
+	};
+
+	FWeatherTerms MakeWeatherTerms(float TemperatureEffect, float VisibilityModifier, float DeltaTime)
+	{
+		// Temperature stress on energy consumption, 0 to 1 scale
+		const float TemperatureStress = FMath::Abs(TemperatureEffect - 0.5f) * 2.0f;
+
+		FWeatherTerms Terms;
+		Terms.EnergyDecay = TemperatureStress * 0.5f * DeltaTime;
+
+		// Extra energy cost in poor visibility
+		Terms.VisibilityCost = VisibilityModifier < 0.5f ? 0.2f * DeltaTime : 0.0f;
+
+		// Faster healing in a comfortable temperature range
+		Terms.bComfortable = TemperatureEffect > 0.3f && TemperatureEffect < 0.8f;
+		Terms.Healing = 6.0f * DeltaTime;
+		return Terms;
+	}
+
+	// Scalar fallback of the ISPC kernels in CreatureMetabolism.ispc, the two must stay in step
+	void StepLifeStatsScalar(FCreatureLifeColumns& Columns, float DeltaTime)
+	{
+		const int32 Num = Columns.Num();
+		float* RESTRICT Energy = Columns.Energy.GetData();
+		float* RESTRICT Hunger = Columns.Hunger.GetData();
+		float* RESTRICT Age = Columns.Age.GetData();
+		float* RESTRICT Health = Columns.Health.GetData();
+		float* RESTRICT Cooldown = Columns.ReproductionCooldown.GetData();
+		const float* RESTRICT EnergyDecayRate = Columns.EnergyDecayRate.GetData();
+		const float* RESTRICT HungerGrowthRate = Columns.HungerGrowthRate.GetData();
+		const float* RESTRICT AgingRate = Columns.AgingRate.GetData();
+
+		// FCreatureMetabolism::StepLifeStats with branches turned into selects
+		for (int32 i = 0; i < Num; i++)
+		{
+			Age[i] += DeltaTime * AgingRate[i];
+			Energy[i] = FMath::Max(0.0f, Energy[i] - EnergyDecayRate[i] * DeltaTime);
+			Hunger[i] = FMath::Min(100.0f, Hunger[i] + HungerGrowthRate[i] * DeltaTime);
+			Cooldown[i] = Cooldown[i] > 0.0f ? Cooldown[i] - DeltaTime : Cooldown[i];
+
+			const bool bStarving = Energy[i] <= 0.0f || Hunger[i] >= 90.0f;
+			const bool bThriving = Energy[i] > 70.0f && Hunger[i] < 30.0f;
+			const float Healed = FMath::Min(100.0f, Health[i] + 5.0f * DeltaTime);
+			Health[i] = bStarving ? Health[i] - 10.0f * DeltaTime : (bThriving ? Healed : Health[i]);
+		}
+	}
+
+	// Time for a value changing at Rate per second to go from From up to To, never if Rate is not positive
+	float TimeToReach(float From, float To, float Rate)
+	{
+		if (To <= From)
+		{
+			return 0.0f;
+		}
+		return Rate > 0.0f ? (To - From) / Rate : TNumericLimits<float>::Max();
+	}
+
+	void ApplyWeatherScalar(FCreatureLifeColumns& Columns, const FWeatherTerms& Terms)
+	{
+		const int32 Num = Columns.Num();
+		float* RESTRICT Energy = Columns.Energy.GetData();
+		float* RESTRICT Health = Columns.Health.GetData();
+		const float* RESTRICT Hunger = Columns.Hunger.GetData();
+
+		for (int32 i = 0; i < Num; i++)
+		{
+			Energy[i] = FMath::Max(0.0f, Energy[i] - Terms.EnergyDecay) - Terms.VisibilityCost;
+
+			const bool bThriving = Terms.bComfortable && Energy[i] > 70.0f && Hunger[i] < 30.0f;
+			Health[i] = bThriving ? FMath::Min(100.0f, Health[i] + Terms.Healing) : Health[i];
+		}
+	}
+}
+
+FCreatureMetabolismRates FCreatureMetabolism::DeriveRates(const FCreatureGenes& Genes)
+{
+	FCreatureMetabolismRates Rates;
+	Rates.EnergyDecayRate = 2.0f / Genes.Endurance;
+	Rates.HungerGrowthRate = 2.0f / Genes.HungerResistance;
+	Rates.HungerResistance = Genes.HungerResistance;
+	Rates.AgingRate = 1.0f / Genes.LifeSpan * 100.0f;
+	Rates.MaturityAge = Genes.LifeSpan * 0.2f;
+	Rates.LifeSpan = Genes.LifeSpan;
+	return Rates;
+}
+
+void FCreatureMetabolism::StepLifeStats(FCreatureLifeState& State, const FCreatureMetabolismRates& Rates, float DeltaTime)
+{
+	// Age the creature
+	State.Age += DeltaTime * Rates.AgingRate;
+
+	// Energy decay
+	float EnergyDecay = Rates.EnergyDecayRate * DeltaTime;
+	State.Energy = FMath::Max(0.0f, State.Energy - EnergyDecay);
+
+	// Hunger growth
+	float HungerGrowth = Rates.HungerGrowthRate * DeltaTime / Rates.HungerResistance;
+	State.Hunger = FMath::Min(100.0f, State.Hunger + HungerGrowth);
+
+	// Reduce reproduction cooldown
+	if (State.ReproductionCooldown > 0.0f)
+	{
+		State.ReproductionCooldown -= DeltaTime;
+	}
+
+	// Health effects
+	if (State.Energy <= 0.0f || State.Hunger >= 90.0f)
+	{
+		State.Health -= 10.0f * DeltaTime;
+	}
+	else if (State.Energy > 70.0f && State.Hunger < 30.0f)
+	{
+		State.Health = FMath::Min(100.0f, State.Health + 5.0f * DeltaTime);
+	}
+}
+
+void FCreatureMetabolism::StepLifeStats(FCreatureLifeColumns& Columns, float DeltaTime)
+{
+	StepLifeStats(Columns, DeltaTime, bCreatureMetabolism_ISPC_Enabled);
+}
+
+void FCreatureMetabolism::StepLifeStats(FCreatureLifeColumns& Columns, float DeltaTime, bool bUseISPC)
+{
+#if INTEL_ISPC
+	if (bUseISPC)
+	{
+		ispc::StepLifeStats(Columns.Energy.GetData(), Columns.Hunger.GetData(), Columns.Age.GetData(), Columns.Health.GetData(), Columns.ReproductionCooldown.GetData(),
+			Columns.EnergyDecayRate.GetData(), Columns.HungerGrowthRate.GetData(), Columns.AgingRate.GetData(), Columns.Num(), DeltaTime);
+		return;
+	}
+#endif
+
+	StepLifeStatsScalar(Columns, DeltaTime);
+}
+
+void FCreatureMetabolism::ApplyWeather(FCreatureLifeColumns& Columns, float TemperatureEffect, float VisibilityModifier, float DeltaTime)
+{
+	ApplyWeather(Columns, TemperatureEffect, VisibilityModifier, DeltaTime, bCreatureMetabolism_ISPC_Enabled);
+}
+
+void FCreatureMetabolism::ApplyWeather(FCreatureLifeColumns& Columns, float TemperatureEffect, float VisibilityModifier, float DeltaTime, bool bUseISPC)
+{
+	const FWeatherTerms Terms = MakeWeatherTerms(TemperatureEffect, VisibilityModifier, DeltaTime);
+
+#if INTEL_ISPC
+	if (bUseISPC)
+	{
+		ispc::ApplyWeather(Columns.Energy.GetData(), Columns.Health.GetData(), Columns.Hunger.GetData(), Columns.Num(),
+			Terms.EnergyDecay, Terms.VisibilityCost, Terms.bComfortable, Terms.Healing);
+		return;
+	}
+#endif
+
+	ApplyWeatherScalar(Columns, Terms);
+}
+
+bool FCreatureMetabolism::HasISPCKernels()
+{
+#if INTEL_ISPC
+	return true;
+#else
+	return false;
+#endif
+}
+
+FCreatureWeatherRates FCreatureMetabolism::GetWeatherRates(float TemperatureEffect, float VisibilityModifier)
+{
+	const FWeatherTerms Terms = MakeWeatherTerms(TemperatureEffect, VisibilityModifier, 1.0f);
+
+	FCreatureWeatherRates Rates;
+	Rates.EnergyDecayRate = Terms.EnergyDecay + Terms.VisibilityCost;
+	Rates.HealingRate = Terms.bComfortable ? Terms.Healing : 0.0f;
+	return Rates;
+}
+
+float FCreatureMetabolism::AdvanceLifeStats(FCreatureLifeState& State, const FCreatureMetabolismRates& Rates, float Interval, const FCreatureWeatherRates& Weather)
+{
+	const float EnergyDecayRate = Rates.EnergyDecayRate + Weather.EnergyDecayRate;
+	const float HungerGrowthRate = Rates.HungerGrowthRate / Rates.HungerResistance;
+	const float HealingRate = 5.0f + Weather.HealingRate;
+	constexpr float StarvingRate = 10.0f;
+
+	// Thriving while energy is above 70 and hunger below 30, starving once energy is empty or hunger reaches 90
+	const bool bThriving = State.Energy > 70.0f && State.Hunger < 30.0f;
+	const float ThrivingTime = bThriving ? FMath::Min(TimeToReach(70.0f, State.Energy, EnergyDecayRate), TimeToReach(State.Hunger, 30.0f, HungerGrowthRate)) : 0.0f;
+	const float StarvingStart = FMath::Min(TimeToReach(0.0f, State.Energy, EnergyDecayRate), TimeToReach(State.Hunger, 90.0f, HungerGrowthRate));
+
+	// Death by old age or by starving through the health left after thriving
+	const float HealthAfterThriving = FMath::Min(100.0f, State.Health + HealingRate * ThrivingTime);
+	const float AgeDeath = TimeToReach(State.Age, Rates.LifeSpan, Rates.AgingRate);
+	const float HealthDeath = State.Health <= 0.0f ? 0.0f : StarvingStart + HealthAfterThriving / StarvingRate;
+	const float Time = FMath::Min(Interval, FMath::Min(AgeDeath, HealthDeath));
+
+	State.Health = FMath::Min(100.0f, State.Health + HealingRate * FMath::Min(Time, ThrivingTime)) - StarvingRate * FMath::Max(0.0f, Time - StarvingStart);
+	State.Age += Rates.AgingRate * Time;
+	State.Energy = FMath::Max(0.0f, State.Energy - EnergyDecayRate * Time);
+	State.Hunger = FMath::Min(100.0f, State.Hunger + HungerGrowthRate * Time);
+	State.ReproductionCooldown = State.ReproductionCooldown > 0.0f ? FMath::Max(0.0f, State.ReproductionCooldown - Time) : State.ReproductionCooldown;
+
+	// Rounding must not leave a creature that died during the interval alive
+	if (Time < Interval)
+	{
+		if (Time == AgeDeath)
+		{
+			State.Age = FMath::Max(State.Age, Rates.LifeSpan);
+		}
+		if (Time == HealthDeath)
+		{
+			State.Health = FMath::Min(State.Health, 0.0f);
+		}
+	}
+	return Time;
+}
+
+bool FCreatureMetabolism::CanReproduce(const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates)
+{
+	return State.Age >= Rates.MaturityAge &&
+		   State.Energy > 50.0f &&
+		   State.Hunger < 70.0f &&
+		   State.ReproductionCooldown <= 0.0f &&
+		   State.Health > 30.0f;
+}
+
+bool FCreatureMetabolism::IsDead(const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates)
+{
+	return State.Health <= 0.0f || State.Age >= Rates.LifeSpan;
+}
+
+void FCreatureMetabolism::ConsumeFood(FCreatureLifeState& State, float FoodValue)
+{
+	State.Energy = FMath::Min(100.0f, State.Energy + FoodValue);
+	State.Hunger = FMath::Max(0.0f, State.Hunger - FoodValue * 0.5f);
+	State.ResourcesGathered += FoodValue;
+}
+
+void FCreatureMetabolism::ApplyReproductionCost(FCreatureLifeState& State, float ReproductionRate)
+{
+	State.Energy -= 30.0f;
+	State.ReproductionCooldown = 20.0f / ReproductionRate;
+	State.OffspringCount++;
+}
+
+float FCreatureMetabolism::ApplyDamage(FCreatureLifeState& State, float DamageAmount, float DamageResistance)
+{
+	float ActualDamage = DamageAmount / DamageResistance;
+	State.Health = FMath::Max(0.0f, State.Health - ActualDamage);
+	return ActualDamage;
+}
+
+float FCreatureMetabolism::CalculateFitness(const FCreatureGenes& Genes, const FCreatureLifeState& State)
+{
+	return Genes.CalculateFitness(State.Age, State.OffspringCount, State.ResourcesGathered, State.CombatWins);
+}
+
+int32 FCreatureLifeColumns::Add(const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates)
+{
+	const int32 Index = Energy.AddUninitialized();
+	Hunger.AddUninitialized();
+	Age.AddUninitialized();
+	Health.AddUninitialized();
+	ReproductionCooldown.AddUninitialized();
+	EnergyDecayRate.AddUninitialized();
+	HungerGrowthRate.AddUninitialized();
+	AgingRate.AddUninitialized();
+	MaturityAge.AddUninitialized();
+	LifeSpan.AddUninitialized();
+
+	SetState(Index, State);
+	SetRates(Index, Rates);
+	return Index;
+}
+
+void FCreatureLifeColumns::RemoveAtSwap(int32 Index)
+{
+	for (TArray<float>* Column : { &Energy, &Hunger, &Age, &Health, &ReproductionCooldown, &EnergyDecayRate, &HungerGrowthRate, &AgingRate, &MaturityAge, &LifeSpan })
+	{
+		Column->RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+void FCreatureLifeColumns::Reset()
+{
+	for (TArray<float>* Column : { &Energy, &Hunger, &Age, &Health, &ReproductionCooldown, &EnergyDecayRate, &HungerGrowthRate, &AgingRate, &MaturityAge, &LifeSpan })
+	{
+		Column->Reset();
+	}
+}
+
+void FCreatureLifeColumns::GetState(int32 Index, FCreatureLifeState& InOutState) const
+{
+	InOutState.Energy = Energy[Index];
+	InOutState.Hunger = Hunger[Index];
+	InOutState.Age = Age[Index];
+	InOutState.Health = Health[Index];
+	InOutState.ReproductionCooldown = ReproductionCooldown[Index];
+}
+
+void FCreatureLifeColumns::SetState(int32 Index, const FCreatureLifeState& State)
+{
+	Energy[Index] = State.Energy;
+	Hunger[Index] = State.Hunger;
+	Age[Index] = State.Age;
+	Health[Index] = State.Health;
+	ReproductionCooldown[Index] = State.ReproductionCooldown;
+}
+
+FCreatureMetabolismRates FCreatureLifeColumns::GetRates(int32 Index) const
+{
+	FCreatureMetabolismRates Rates;
+	Rates.EnergyDecayRate = EnergyDecayRate[Index];
+	Rates.HungerGrowthRate = HungerGrowthRate[Index];
+	Rates.HungerResistance = 1.0f;
+	Rates.AgingRate = AgingRate[Index];
+	Rates.MaturityAge = MaturityAge[Index];
+	Rates.LifeSpan = LifeSpan[Index];
+	return Rates;
+}
+
+int32 FCreatureLifeColumns::AddFrom(const FCreatureLifeColumns& Other, int32 Index)
+{
+	FCreatureLifeState State;
+	Other.GetState(Index, State);
+	return Add(State, Other.GetRates(Index));
+}
+
+void FCreatureLifeColumns::SetRates(int32 Index, const FCreatureMetabolismRates& Rates)
+{
+	EnergyDecayRate[Index] = Rates.EnergyDecayRate;
+	HungerGrowthRate[Index] = Rates.HungerGrowthRate / Rates.HungerResistance;
+	AgingRate[Index] = Rates.AgingRate;
+	MaturityAge[Index] = Rates.MaturityAge;
+	LifeSpan[Index] = Rates.LifeSpan;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	void FillRandomColumns(FCreatureLifeColumns& Columns, int32 NumCreatures)
+	{
+		FSimulationRandomStream Stream(0, 0, 0, ERandomStreamPurpose::Creature);
+		Columns.Reset();
+
+		for (int32 i = 0; i < NumCreatures; i++)
+		{
+			FCreatureLifeState State;
+			State.Energy = Stream.FRandRange(0.0f, 100.0f);
+			State.Hunger = Stream.FRandRange(0.0f, 100.0f);
+			State.Age = Stream.FRandRange(0.0f, 50.0f);
+			State.Health = Stream.FRandRange(0.0f, 100.0f);
+			State.ReproductionCooldown = Stream.FRandRange(-1.0f, 20.0f);
+			Columns.Add(State, FCreatureMetabolism::DeriveRates(FCreatureGenes::GenerateRandom(Stream)));
+		}
+	}
+
+	// Creatures per microsecond of one path, agreement of the paths is covered by EcosystemSandbox.Metabolism.ISPCMatchesScalar
+	double MeasureMetabolism(int32 NumCreatures, int32 NumSteps, bool bUseISPC)
+	{
+		constexpr float DeltaTime = 1.0f / 60.0f;
+
+		// Cold fog and mild clear weather alternate so every weather term is exercised
+		const FVector2f Weathers[2] = { FVector2f(0.1f, 0.3f), FVector2f(0.5f, 1.0f) };
+
+		FCreatureLifeColumns Columns;
+		FillRandomColumns(Columns, NumCreatures);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Step = 0; Step < NumSteps; Step++)
+		{
+			const FVector2f& Weather = Weathers[Step % 2];
+			FCreatureMetabolism::StepLifeStats(Columns, DeltaTime, bUseISPC);
+			FCreatureMetabolism::ApplyWeather(Columns, Weather.X, Weather.Y, DeltaTime, bUseISPC);
+		}
+		return static_cast<double>(NumCreatures) * NumSteps / ((FPlatformTime::Seconds() - StartTime) * 1e6);
+	}
+
+	void BenchmarkMetabolism(const TArray<FString>& Args)
+	{
+		const int32 NumCreatures = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+		const int32 NumSteps = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1000;
+
+		const double ScalarRate = MeasureMetabolism(NumCreatures, NumSteps, false);
+		UE_LOG(LogTemp, Display, TEXT("Metabolism scalar: %d creatures x %d steps, %.1f creatures per microsecond"), NumCreatures, NumSteps, ScalarRate);
+
+		if (FCreatureMetabolism::HasISPCKernels())
+		{
+			const double VectorRate = MeasureMetabolism(NumCreatures, NumSteps, true);
+			UE_LOG(LogTemp, Display, TEXT("Metabolism ISPC: %.1f creatures per microsecond, %.2fx scalar"), VectorRate, VectorRate / ScalarRate);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Display, TEXT("Metabolism ISPC kernels are not compiled for this platform"));
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdBenchmarkMetabolism(
+	TEXT("Ecosystem.Metabolism.Benchmark"),
+	TEXT("Steps random creatures through the scalar and ISPC metabolism and reports creatures per microsecond of each. Args: [Creatures=10000] [Steps=1000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkMetabolism));
+#endif
@@ -0,0 +1,159 @@
+#include "CreaturePoolSubsystem.h"
+#include "Creature.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+void UCreaturePoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UCreaturePoolSubsystem::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UCreaturePoolSubsystem::OnPostGarbageCollect);
+}
+
+void UCreaturePoolSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	Super::Deinitialize();
+}
+
+ACreature* UCreaturePoolSubsystem::AcquireCreature(TSubclassOf<ACreature> CreatureClass, const FTransform& Transform)
+{
+	if (!CreatureClass)
+	{
+		return nullptr;
+	}
+
+	// Most recently released first, usually the only class in the pool
+	for (int32 i = PooledCreatures.Num() - 1; i >= 0; i--)
+	{
+		ACreature* Creature = PooledCreatures[i];
+		if (!IsValid(Creature))
+		{
+			PooledCreatures.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if (Creature->GetClass() == CreatureClass)
+		{
+			PooledCreatures.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			Creature->ResetForReuse(Transform);
+			Hits++;
+			return Creature;
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	const double StartTime = FPlatformTime::Seconds();
+	ACreature* NewCreature = GetWorld()->SpawnActor<ACreature>(CreatureClass, Transform, SpawnParams);
+	TotalSpawnSeconds += FPlatformTime::Seconds() - StartTime;
+	Misses++;
+
+	return NewCreature;
+}
+
+void UCreaturePoolSubsystem::ReleaseCreature(ACreature* Creature)
+{
+	if (!IsValid(Creature) || Creature->IsPooled())
+	{
+		return;
+	}
+
+	Releases++;
+
+	if (PooledCreatures.Num() >= MaxPooledCreatures)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Creature->Destroy();
+		TotalDestroySeconds += FPlatformTime::Seconds() - StartTime;
+		Overflows++;
+		return;
+	}
+
+	Creature->DeactivateForPool();
+	PooledCreatures.Add(Creature);
+}
+
+void UCreaturePoolSubsystem::SetMaxPooledCreatures(int32 NewMax)
+{
+	MaxPooledCreatures = FMath::Max(0, NewMax);
+
+	while (PooledCreatures.Num() > MaxPooledCreatures)
+	{
+		ACreature* Creature = PooledCreatures.Pop(EAllowShrinking::No);
+		if (IsValid(Creature))
+		{
+			Creature->Destroy();
+		}
+	}
+}
+
+FCreaturePoolStats UCreaturePoolSubsystem::GetPoolStats() const
+{
+	FCreaturePoolStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Releases = Releases;
+	Stats.Overflows = Overflows;
+	Stats.PooledCount = PooledCreatures.Num();
+
+	const int32 Acquires = Hits + Misses;
+	Stats.HitRate = Acquires > 0 ? static_cast<float>(Hits) / Acquires : 0.0f;
+	Stats.AverageSpawnMs = Misses > 0 ? static_cast<float>(TotalSpawnSeconds * 1000.0 / Misses) : 0.0f;
+	Stats.AverageDestroyMs = Overflows > 0 ? static_cast<float>(TotalDestroySeconds * 1000.0 / Overflows) : 0.0f;
+
+	// Every hit skipped a spawn, every pooled release skipped a destroy and the collection that follows it
+	Stats.DestroysAvoided = Releases - Overflows;
+	Stats.EstimatedTimeSavedMs = Hits * Stats.AverageSpawnMs + Stats.DestroysAvoided * Stats.AverageDestroyMs;
+
+	Stats.bPoolingEnabled = MaxPooledCreatures > 0;
+	Stats.GarbageCollections = GarbageCollections;
+	Stats.GarbageCollectionMs = static_cast<float>(TotalGarbageCollectSeconds * 1000.0);
+	Stats.MaxGarbageCollectionMs = static_cast<float>(MaxGarbageCollectSeconds * 1000.0);
+	Stats.Generations = Generations;
+	Stats.GarbageCollectionMsPerGeneration = Generations > 0 ? static_cast<float>((TotalGarbageCollectSeconds - GenerationGarbageCollectSeconds) * 1000.0 / Generations) : 0.0f;
+	Stats.LastGenerationGarbageCollectionMs = static_cast<float>(LastGenerationGarbageCollectSeconds * 1000.0);
+
+	return Stats;
+}
+
+void UCreaturePoolSubsystem::ResetPoolStats()
+{
+	Hits = 0;
+	Misses = 0;
+	Releases = 0;
+	Overflows = 0;
+	TotalSpawnSeconds = 0.0;
+	TotalDestroySeconds = 0.0;
+	GarbageCollections = 0;
+	TotalGarbageCollectSeconds = 0.0;
+	MaxGarbageCollectSeconds = 0.0;
+	GenerationGarbageCollectSeconds = 0.0;
+	LastGenerationGarbageCollectSeconds = 0.0;
+	Generations = 0;
+}
+
+void UCreaturePoolSubsystem::NotifyGenerationComplete()
+{
+	LastGenerationGarbageCollectSeconds = GenerationGarbageCollectSeconds;
+	GenerationGarbageCollectSeconds = 0.0;
+	Generations++;
+}
+
+void UCreaturePoolSubsystem::OnPreGarbageCollect()
+{
+	GarbageCollectStartTime = FPlatformTime::Seconds();
+}
+
+void UCreaturePoolSubsystem::OnPostGarbageCollect()
+{
+	const double Seconds = FPlatformTime::Seconds() - GarbageCollectStartTime;
+	GarbageCollections++;
+	TotalGarbageCollectSeconds += Seconds;
+	GenerationGarbageCollectSeconds += Seconds;
+	MaxGarbageCollectSeconds = FMath::Max(MaxGarbageCollectSeconds, Seconds);
+}
@@ -0,0 +1,243 @@
+#include "CreatureSignificanceSubsystem.h"
+#include "Creature.h"
+#include "Algo/Sort.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static bool bCreatureSignificanceEnabled = true;
+static FAutoConsoleVariableRef CVarCreatureSignificanceEnabled(TEXT("Ecosystem.Significance.Enabled"), bCreatureSignificanceEnabled,
+	TEXT("Whether distant and idle creatures tick at reduced rates, when off every creature settles back to every frame ticking"));
+
+void UCreatureSignificanceSubsystem::Deinitialize()
+{
+	while (Creatures.Num() > 0)
+	{
+		Unregister(Creatures.Last());
+	}
+
+	Super::Deinitialize();
+}
+
+TStatId UCreatureSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCreatureSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UCreatureSignificanceSubsystem::Register(ACreature* Creature)
+{
+	check(Creature && Creature->SignificanceSlot == INDEX_NONE);
+
+	const int32 Slot = Creatures.Add(Creature);
+	Tiers.Add(ECreatureSignificance::Full);
+	ViewDistancesSquared.Add(TNumericLimits<float>::Max());
+	TierCounts[static_cast<int32>(ECreatureSignificance::Full)]++;
+
+	Creature->Significance = this;
+	Creature->SignificanceSlot = Slot;
+	Creature->SetTickInterval(TierTickIntervals[static_cast<int32>(ECreatureSignificance::Full)]);
+}
+
+void UCreatureSignificanceSubsystem::Unregister(ACreature* Creature)
+{
+	const int32 Slot = Creature ? Creature->SignificanceSlot : INDEX_NONE;
+	if (!Creatures.IsValidIndex(Slot) || Creatures[Slot] != Creature)
+	{
+		return;
+	}
+
+	SetTier(Slot, ECreatureSignificance::Full);
+	TierCounts[static_cast<int32>(ECreatureSignificance::Full)]--;
+
+	Creature->Significance = nullptr;
+	Creature->SignificanceSlot = INDEX_NONE;
+
+	Creatures.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	Tiers.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	ViewDistancesSquared.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+	if (Creatures.IsValidIndex(Slot))
+	{
+		Creatures[Slot]->SignificanceSlot = Slot;
+	}
+}
+
+void UCreatureSignificanceSubsystem::NotifyInteraction(ACreature* Creature)
+{
+	const int32 Slot = Creature ? Creature->SignificanceSlot : INDEX_NONE;
+	if (Creatures.IsValidIndex(Slot) && Creatures[Slot] == Creature && Tiers[Slot] > ECreatureSignificance::High &&
+		Creature->GetCurrentState() != ECreatureState::Dying)
+	{
+		SetTier(Slot, ECreatureSignificance::High);
+	}
+}
+
+void UCreatureSignificanceSubsystem::AddPointOfInterest(AActor* Actor)
+{
+	if (Actor)
+	{
+		PointsOfInterest.AddUnique(Actor);
+	}
+}
+
+void UCreatureSignificanceSubsystem::RemovePointOfInterest(AActor* Actor)
+{
+	PointsOfInterest.RemoveSwap(Actor);
+}
+
+ECreatureSignificance UCreatureSignificanceSubsystem::GetSignificance(const ACreature* Creature) const
+{
+	const int32 Slot = Creature ? Creature->SignificanceSlot : INDEX_NONE;
+	return Creatures.IsValidIndex(Slot) && Creatures[Slot] == Creature ? Tiers[Slot] : ECreatureSignificance::Full;
+}
+
+void UCreatureSignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int32 Num = Creatures.Num();
+	if (Num == 0)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	GatherViewpoints();
+
+	// Enough creatures per frame to visit each once per RefreshSeconds
+	const int32 SliceSize = FMath::Clamp(FMath::CeilToInt32(Num * DeltaTime / RefreshSeconds), 1, Num);
+	for (int32 i = 0; i < SliceSize; i++)
+	{
+		if (NextSlot >= Num)
+		{
+			NextSlot = 0;
+			UpdateFullRateDistance();
+		}
+
+		const int32 Slot = NextSlot++;
+		const FVector Location = Creatures[Slot]->GetActorLocation();
+
+		float DistanceSquared = TNumericLimits<float>::Max();
+		for (const FVector& Viewpoint : Viewpoints)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, static_cast<float>(FVector::DistSquared(Location, Viewpoint)));
+		}
+		ViewDistancesSquared[Slot] = DistanceSquared;
+
+		SetTier(Slot, Evaluate(Creatures[Slot], Tiers[Slot], DistanceSquared, Now));
+	}
+
+	LastUpdateMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UCreatureSignificanceSubsystem::GatherViewpoints()
+{
+	Viewpoints.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			Viewpoints.Add(Location);
+		}
+	}
+
+	PointsOfInterest.RemoveAllSwap([](const TWeakObjectPtr<AActor>& Actor) { return !Actor.IsValid(); });
+	for (const TWeakObjectPtr<AActor>& Actor : PointsOfInterest)
+	{
+		Viewpoints.Add(Actor->GetActorLocation());
+	}
+}
+
+void UCreatureSignificanceSubsystem::UpdateFullRateDistance()
+{
+	// Pulls the full rate distance in until only the nearest MaxFullRateCreatures are inside it
+	const float BaseDistanceSquared = FMath::Square(TierDistances[0]);
+	FullRateDistanceSquared = BaseDistanceSquared;
+
+	NearDistancesSquared.Reset();
+	for (const float DistanceSquared : ViewDistancesSquared)
+	{
+		if (DistanceSquared < BaseDistanceSquared)
+		{
+			NearDistancesSquared.Add(DistanceSquared);
+		}
+	}
+
+	if (NearDistancesSquared.Num() > MaxFullRateCreatures)
+	{
+		Algo::Sort(NearDistancesSquared);
+		FullRateDistanceSquared = NearDistancesSquared[MaxFullRateCreatures];
+	}
+}
+
+ECreatureSignificance UCreatureSignificanceSubsystem::Evaluate(const ACreature* Creature, ECreatureSignificance Current, float DistanceSquared, float Now) const
+{
+	if (!bCreatureSignificanceEnabled)
+	{
+		return ECreatureSignificance::Full;
+	}
+
+	const int32 CurrentTier = static_cast<int32>(Current);
+	const bool bFullRateLimited = FullRateDistanceSquared < FMath::Square(TierDistances[0]);
+
+	// Distance tier, a creature keeps its tier until it is past the hysteresis band
+	int32 Tier = NumTiers - 1;
+	for (int32 i = 0; i < NumTiers - 1; i++)
+	{
+		const float TierDistanceSquared = i == 0 ? FullRateDistanceSquared : FMath::Square(TierDistances[i]);
+		const bool bHysteresis = CurrentTier <= i && !(i == 0 && bFullRateLimited);
+		if (DistanceSquared < (bHysteresis ? TierDistanceSquared * FMath::Square(DemotionHysteresis) : TierDistanceSquared))
+		{
+			Tier = i;
+			break;
+		}
+	}
+
+	switch (Creature->GetCurrentState())
+	{
+		case ECreatureState::Fighting:
+		case ECreatureState::Fleeing:
+		case ECreatureState::Mating:
+			Tier = FMath::Min(Tier, static_cast<int32>(ECreatureSignificance::High));
+			break;
+
+		case ECreatureState::Idle:
+			// Close to a view idling still shows, further out it can wait
+			Tier = Tier == 0 ? Tier : FMath::Min(Tier + 1, NumTiers - 1);
+			break;
+
+		case ECreatureState::Dying:
+			Tier = NumTiers - 1;
+			break;
+
+		default:
+			break;
+	}
+
+	if (Creature->GetCurrentState() != ECreatureState::Dying && Now - Creature->GetLastInteractionTime() < InteractionGraceSeconds)
+	{
+		Tier = FMath::Min(Tier, static_cast<int32>(ECreatureSignificance::High));
+	}
+
+	return static_cast<ECreatureSignificance>(Tier);
+}
+
+void UCreatureSignificanceSubsystem::SetTier(int32 Slot, ECreatureSignificance Tier)
+{
+	if (Tiers[Slot] == Tier)
+	{
+		return;
+	}
+
+	TierCounts[static_cast<int32>(Tiers[Slot])]--;
+	TierCounts[static_cast<int32>(Tier)]++;
+	Tiers[Slot] = Tier;
+
+	Creatures[Slot]->SetTickInterval(TierTickIntervals[static_cast<int32>(Tier)]);
+	Creatures[Slot]->SetHibernating(Tier == ECreatureSignificance::Low);
+}
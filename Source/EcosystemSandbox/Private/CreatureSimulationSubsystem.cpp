@@ -0,0 +1,368 @@
+#include "CreatureSimulationSubsystem.h"
+#include "Creature.h"
+#include "DynamicWeatherSystem.h"
+#include "EcosystemClockSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace
+{
+	constexpr uint8 NoTransition = 0;
+	constexpr uint8 StatsChanged = 1;
+	constexpr uint8 Died = 2;
+}
+
+void UCreatureSimulationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UEcosystemClockSubsystem* Clock = Collection.InitializeDependency<UEcosystemClockSubsystem>();
+	Clock->OnSimulationStep.AddUObject(this, &UCreatureSimulationSubsystem::Step);
+}
+
+void UCreatureSimulationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	WeatherSystem = Cast<ADynamicWeatherSystem>(UGameplayStatics::GetActorOfClass(&InWorld, ADynamicWeatherSystem::StaticClass()));
+}
+
+void UCreatureSimulationSubsystem::Deinitialize()
+{
+	while (Creatures.Num() > 0)
+	{
+		Unregister(Creatures.Last());
+	}
+
+	while (SleepingCreatures.Num() > 0)
+	{
+		Unregister(SleepingCreatures.Last());
+	}
+
+	Super::Deinitialize();
+}
+
+int32 UCreatureSimulationSubsystem::Register(ACreature* Creature, const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates)
+{
+	check(Creature && Creature->SimulationSlot == INDEX_NONE);
+
+	const int32 Slot = Columns.Add(State, Rates);
+	Creatures.Add(Creature);
+
+	// Nothing notified yet, so the first update reaches the blackboard
+	NotifiedEnergy.Add(TNumericLimits<float>::Lowest());
+	NotifiedHunger.Add(TNumericLimits<float>::Lowest());
+	NotifiedCanReproduce.Add(false);
+
+	Creature->Simulation = this;
+	Creature->SimulationSlot = Slot;
+	Creature->SetMovementModifier(MovementModifier);
+	return Slot;
+}
+
+void UCreatureSimulationSubsystem::Unregister(ACreature* Creature)
+{
+	const int32 Slot = Creature ? Creature->SimulationSlot : INDEX_NONE;
+	const TArray<ACreature*>& Owners = Creature && Creature->bHibernating ? SleepingCreatures : Creatures;
+	if (!Owners.IsValidIndex(Slot) || Owners[Slot] != Creature)
+	{
+		return;
+	}
+
+	// Read through the slot, then write the fields once the creature owns its stats again
+	const FCreatureLifeState State = Creature->GetLifeState();
+	const bool bHibernating = Creature->bHibernating;
+	Creature->Simulation = nullptr;
+	Creature->SimulationSlot = INDEX_NONE;
+	Creature->bHibernating = false;
+	Creature->SetLifeState(State);
+
+	if (bHibernating)
+	{
+		RemoveSleeping(Slot);
+	}
+	else
+	{
+		RemoveAwake(Slot);
+	}
+}
+
+void UCreatureSimulationSubsystem::RemoveAwake(int32 Slot)
+{
+	Columns.RemoveAtSwap(Slot);
+	Creatures.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	NotifiedEnergy.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	NotifiedHunger.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	NotifiedCanReproduce.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+	if (Creatures.IsValidIndex(Slot))
+	{
+		Creatures[Slot]->SimulationSlot = Slot;
+	}
+}
+
+void UCreatureSimulationSubsystem::RemoveSleeping(int32 SleepSlot)
+{
+	SleepingColumns.RemoveAtSwap(SleepSlot);
+	SleepingCreatures.RemoveAtSwap(SleepSlot, 1, EAllowShrinking::No);
+	Hibernations.RemoveAtSwap(SleepSlot, 1, EAllowShrinking::No);
+
+	if (SleepingCreatures.IsValidIndex(SleepSlot))
+	{
+		SleepingCreatures[SleepSlot]->SimulationSlot = SleepSlot;
+	}
+}
+
+void UCreatureSimulationSubsystem::Hibernate(ACreature* Creature)
+{
+	const int32 Slot = Creature && !Creature->bHibernating ? Creature->SimulationSlot : INDEX_NONE;
+	if (!Creatures.IsValidIndex(Slot) || Creatures[Slot] != Creature)
+	{
+		return;
+	}
+
+	const int32 SleepSlot = SleepingColumns.AddFrom(Columns, Slot);
+	SleepingCreatures.Add(Creature);
+
+	FHibernation& Hibernation = Hibernations.AddDefaulted_GetRef();
+	Hibernation.Start = SimulatedSeconds;
+	Hibernation.WeatherEnergyDecay = WeatherEnergyDecay;
+	Hibernation.WeatherHealing = WeatherHealing;
+	Schedule(SleepSlot);
+
+	RemoveAwake(Slot);
+	Creature->SimulationSlot = SleepSlot;
+	Creature->bHibernating = true;
+}
+
+void UCreatureSimulationSubsystem::Wake(ACreature* Creature)
+{
+	const int32 SleepSlot = Creature && Creature->bHibernating ? Creature->SimulationSlot : INDEX_NONE;
+	if (!SleepingCreatures.IsValidIndex(SleepSlot) || SleepingCreatures[SleepSlot] != Creature)
+	{
+		return;
+	}
+
+	CatchUp(SleepSlot);
+
+	const int32 Slot = Columns.AddFrom(SleepingColumns, SleepSlot);
+	Creatures.Add(Creature);
+
+	// The blackboard has not heard from the creature while it slept
+	NotifiedEnergy.Add(TNumericLimits<float>::Lowest());
+	NotifiedHunger.Add(TNumericLimits<float>::Lowest());
+	NotifiedCanReproduce.Add(false);
+
+	RemoveSleeping(SleepSlot);
+	Creature->SimulationSlot = Slot;
+	Creature->bHibernating = false;
+}
+
+void UCreatureSimulationSubsystem::GetState(const ACreature* Creature, FCreatureLifeState& InOutState) const
+{
+	const int32 Slot = Creature->SimulationSlot;
+	if (!Creature->bHibernating)
+	{
+		Columns.GetState(Slot, InOutState);
+		return;
+	}
+
+	SleepingColumns.GetState(Slot, InOutState);
+	const FHibernation& Hibernation = Hibernations[Slot];
+	FCreatureMetabolism::AdvanceLifeStats(InOutState, SleepingColumns.GetRates(Slot), static_cast<float>(SimulatedSeconds - Hibernation.Start), GetAverageWeather(Hibernation));
+}
+
+void UCreatureSimulationSubsystem::SetState(const ACreature* Creature, const FCreatureLifeState& State)
+{
+	const int32 Slot = Creature->SimulationSlot;
+	if (!Creature->bHibernating)
+	{
+		Columns.SetState(Slot, State);
+		return;
+	}
+
+	// The new stats are current, and may bring death closer
+	SleepingColumns.SetState(Slot, State);
+	FHibernation& Hibernation = Hibernations[Slot];
+	Hibernation.Start = SimulatedSeconds;
+	Hibernation.WeatherEnergyDecay = WeatherEnergyDecay;
+	Hibernation.WeatherHealing = WeatherHealing;
+	Schedule(Slot);
+}
+
+void UCreatureSimulationSubsystem::SetRates(const ACreature* Creature, const FCreatureMetabolismRates& Rates)
+{
+	const int32 Slot = Creature->SimulationSlot;
+	if (!Creature->bHibernating)
+	{
+		Columns.SetRates(Slot, Rates);
+		return;
+	}
+
+	// Time slept so far ran at the old rates
+	CatchUp(Slot);
+	SleepingColumns.SetRates(Slot, Rates);
+	Schedule(Slot);
+}
+
+void UCreatureSimulationSubsystem::CatchUp(int32 SleepSlot)
+{
+	FHibernation& Hibernation = Hibernations[SleepSlot];
+	const float Interval = static_cast<float>(SimulatedSeconds - Hibernation.Start);
+	if (Interval > 0.0f)
+	{
+		FCreatureLifeState State;
+		SleepingColumns.GetState(SleepSlot, State);
+		FCreatureMetabolism::AdvanceLifeStats(State, SleepingColumns.GetRates(SleepSlot), Interval, GetAverageWeather(Hibernation));
+		SleepingColumns.SetState(SleepSlot, State);
+	}
+
+	Hibernation.Start = SimulatedSeconds;
+	Hibernation.WeatherEnergyDecay = WeatherEnergyDecay;
+	Hibernation.WeatherHealing = WeatherHealing;
+}
+
+void UCreatureSimulationSubsystem::Schedule(int32 SleepSlot)
+{
+	FCreatureLifeState State;
+	SleepingColumns.GetState(SleepSlot, State);
+	const float Time = FCreatureMetabolism::AdvanceLifeStats(State, SleepingColumns.GetRates(SleepSlot), MaxHibernationSeconds, WeatherRates);
+	Hibernations[SleepSlot].WakeTime = Hibernations[SleepSlot].Start + Time;
+}
+
+FCreatureWeatherRates UCreatureSimulationSubsystem::GetAverageWeather(const FHibernation& Hibernation) const
+{
+	FCreatureWeatherRates Average;
+	const double Interval = SimulatedSeconds - Hibernation.Start;
+	if (Interval > 0.0)
+	{
+		Average.EnergyDecayRate = static_cast<float>((WeatherEnergyDecay - Hibernation.WeatherEnergyDecay) / Interval);
+		Average.HealingRate = static_cast<float>((WeatherHealing - Hibernation.WeatherHealing) / Interval);
+	}
+	return Average;
+}
+
+void UCreatureSimulationSubsystem::Step(float DeltaTime)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	const bool bHasWeather = IsValid(WeatherSystem);
+	const float TemperatureEffect = bHasWeather ? WeatherSystem->GetTemperatureEffect() : 0.5f;
+	const float VisibilityModifier = bHasWeather ? WeatherSystem->GetVisibilityModifier() : 1.0f;
+	WeatherRates = bHasWeather ? FCreatureMetabolism::GetWeatherRates(TemperatureEffect, VisibilityModifier) : FCreatureWeatherRates();
+
+	SimulatedSeconds += DeltaTime;
+	WeatherEnergyDecay += WeatherRates.EnergyDecayRate * DeltaTime;
+	WeatherHealing += WeatherRates.HealingRate * DeltaTime;
+
+	if (DeltaTime <= MaxSteppedDeltaTime)
+	{
+		FCreatureMetabolism::StepLifeStats(Columns, DeltaTime);
+
+		if (bHasWeather)
+		{
+			FCreatureMetabolism::ApplyWeather(Columns, TemperatureEffect, VisibilityModifier, DeltaTime);
+		}
+	}
+	else
+	{
+		for (int32 i = 0; i < Columns.Num(); i++)
+		{
+			FCreatureLifeState State;
+			Columns.GetState(i, State);
+			FCreatureMetabolism::AdvanceLifeStats(State, Columns.GetRates(i), DeltaTime, WeatherRates);
+			Columns.SetState(i, State);
+		}
+	}
+
+	if (bHasWeather)
+	{
+		// Walk speeds only change with the weather, not per step
+		const float NewMovementModifier = WeatherSystem->GetMovementModifier();
+		if (FMath::Abs(NewMovementModifier - MovementModifier) >= MovementModifierThreshold)
+		{
+			MovementModifier = NewMovementModifier;
+			for (ACreature* Creature : Creatures)
+			{
+				Creature->SetMovementModifier(MovementModifier);
+			}
+
+			// Hibernation only covers life stats, sleepers still walk
+			for (ACreature* Creature : SleepingCreatures)
+			{
+				Creature->SetMovementModifier(MovementModifier);
+			}
+		}
+	}
+
+	WakeDue();
+	NotifyTransitions();
+
+	LastUpdateMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UCreatureSimulationSubsystem::WakeDue()
+{
+	// Backwards, waking moves the last sleeper into the freed slot
+	for (int32 i = Hibernations.Num() - 1; i >= 0; i--)
+	{
+		if (Hibernations[i].WakeTime > SimulatedSeconds)
+		{
+			continue;
+		}
+
+		// The dying wake so that NotifyTransitions handles them like everyone else
+		CatchUp(i);
+		if (SleepingColumns.IsDead(i))
+		{
+			Wake(SleepingCreatures[i]);
+			continue;
+		}
+
+		Schedule(i);
+		SleepingCreatures[i]->NotifyLifeStatsChanged(SleepingColumns.CanReproduce(i));
+	}
+}
+
+void UCreatureSimulationSubsystem::NotifyTransitions()
+{
+	const int32 Num = Columns.Num();
+	Transitions.SetNumUninitialized(Num);
+
+	// Flags every creature in one branch-free pass, only the few that changed are touched afterwards
+	for (int32 i = 0; i < Num; i++)
+	{
+		const bool bChanged = (Columns.CanReproduce(i) != (NotifiedCanReproduce[i] != 0)) |
+			(FMath::Abs(Columns.Energy[i] - NotifiedEnergy[i]) >= BlackboardThreshold) |
+			(FMath::Abs(Columns.Hunger[i] - NotifiedHunger[i]) >= BlackboardThreshold);
+		Transitions[i] = Columns.IsDead(i) ? Died : (bChanged ? StatsChanged : NoTransition);
+	}
+
+	// Death unregisters and moves slots, so the dead are collected first
+	TArray<ACreature*, TInlineAllocator<16>> Dead;
+	for (int32 i = 0; i < Num; i++)
+	{
+		if (Transitions[i] == NoTransition)
+		{
+			continue;
+		}
+
+		if (Transitions[i] == Died)
+		{
+			Dead.Add(Creatures[i]);
+			continue;
+		}
+
+		NotifiedEnergy[i] = Columns.Energy[i];
+		NotifiedHunger[i] = Columns.Hunger[i];
+		NotifiedCanReproduce[i] = Columns.CanReproduce(i);
+		Creatures[i]->NotifyLifeStatsChanged(NotifiedCanReproduce[i] != 0);
+	}
+
+	for (ACreature* Creature : Dead)
+	{
+		if (IsValid(Creature))
+		{
+			Creature->Die();
+		}
+	}
+}
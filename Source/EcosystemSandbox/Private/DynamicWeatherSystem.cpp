@@ -8,6 +8,7 @@
 #include "Engine/SkyLight.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Engine/World.h"
+#include "EcosystemClockSubsystem.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 
@@ -64,22 +65,18 @@ void ADynamicWeatherSystem::BeginPlay()
 	InitializeComponents();
 	SetupLumenGlobalIllumination();
 	ForceWeatherUpdate();
+
+	// Time of day and weather changes follow the simulation clock, the visuals follow frames
+	if (UEcosystemClockSubsystem* Clock = GetWorld()->GetSubsystem<UEcosystemClockSubsystem>())
+	{
+		Clock->OnSimulationStep.AddUObject(this, &ADynamicWeatherSystem::StepSimulation);
+	}
 }
 
 void ADynamicWeatherSystem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (bDynamicTimeOfDay)
-	{
-		UpdateTimeOfDay(DeltaTime);
-	}
-
-	if (bDynamicWeather)
-	{
-		UpdateWeatherEffects(DeltaTime);
-	}
-
 	UpdateSunPosition();
 	UpdateSkyLighting();
 	UpdateWeatherParticles();
@@ -345,6 +342,19 @@ float ADynamicWeatherSystem::GetMovementModifier() const
 	return FMath::Clamp(Movement, 0.5f, 1.0f);
 }
 
+void ADynamicWeatherSystem::StepSimulation(float StepSeconds)
+{
+	if (bDynamicTimeOfDay)
+	{
+		UpdateTimeOfDay(StepSeconds);
+	}
+
+	if (bDynamicWeather)
+	{
+		UpdateWeatherEffects(StepSeconds);
+	}
+}
+
 void ADynamicWeatherSystem::UpdateTimeOfDay(float DeltaTime)
 {
 	float HourIncrement = (24.0f / DayDuration) * DeltaTime;
@@ -391,7 +401,7 @@ void ADynamicWeatherSystem::UpdateWeatherEffects(float DeltaTime)
 	}
 
 	// Random weather changes
-	float CurrentTime = GetWorld()->GetTimeSeconds();
+	const double CurrentTime = UEcosystemClockSubsystem::GetSimulationSeconds(GetWorld());
 	if (CurrentTime - LastWeatherChangeTime > WeatherChangeInterval)
 	{
 		EWeatherType NewWeather = GenerateRandomWeather();
@@ -0,0 +1,177 @@
+#include "EcosystemClockSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/CommandLine.h"
+
+void UEcosystemClockSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	bFastForward = FParse::Param(FCommandLine::Get(), TEXT("FastForward"));
+	WindowStartWallSeconds = FPlatformTime::Seconds();
+}
+
+void UEcosystemClockSubsystem::Deinitialize()
+{
+	OnSimulationStep.Clear();
+
+	Super::Deinitialize();
+}
+
+TStatId UEcosystemClockSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEcosystemClockSubsystem, STATGROUP_Tickables);
+}
+
+double UEcosystemClockSubsystem::GetSimulationSeconds(const UWorld* World)
+{
+	if (!World)
+	{
+		return 0.0;
+	}
+
+	const UEcosystemClockSubsystem* Clock = World->GetSubsystem<UEcosystemClockSubsystem>();
+	return Clock ? Clock->SimulationSeconds : World->GetTimeSeconds();
+}
+
+void UEcosystemClockSubsystem::SetRunning(bool bNewRunning)
+{
+	if (bRunning == bNewRunning)
+	{
+		return;
+	}
+
+	bRunning = bNewRunning;
+	Accumulator = 0.0;
+	WindowStartWallSeconds = FPlatformTime::Seconds();
+	WindowStartSimulationSeconds = SimulationSeconds;
+	WindowDroppedSeconds = 0.0;
+
+	if (!bRunning)
+	{
+		if (AWorldSettings* WorldSettings = GetWorld()->GetWorldSettings())
+		{
+			WorldSettings->SetTimeDilation(1.0f);
+		}
+	}
+}
+
+void UEcosystemClockSubsystem::SetTimeScale(float NewTimeScale)
+{
+	TimeScale = FMath::Max(0.0f, NewTimeScale);
+}
+
+void UEcosystemClockSubsystem::SetFixedDeltaTime(float NewFixedDeltaTime)
+{
+	FixedDeltaTime = FMath::Max(0.001f, NewFixedDeltaTime);
+}
+
+void UEcosystemClockSubsystem::SetStepBudgetMs(float NewStepBudgetMs)
+{
+	StepBudgetMs = FMath::Max(0.0f, NewStepBudgetMs);
+}
+
+void UEcosystemClockSubsystem::SetMaxSubstepsPerFrame(int32 NewMaxSubsteps)
+{
+	MaxSubstepsPerFrame = FMath::Max(0, NewMaxSubsteps);
+}
+
+void UEcosystemClockSubsystem::SetMaxWorldTimeDilation(float NewMaxWorldTimeDilation)
+{
+	MaxWorldTimeDilation = FMath::Max(1.0f, NewMaxWorldTimeDilation);
+}
+
+void UEcosystemClockSubsystem::SetFastForward(bool bNewFastForward)
+{
+	bFastForward = bNewFastForward;
+	Accumulator = 0.0;
+}
+
+void UEcosystemClockSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bRunning)
+	{
+		return;
+	}
+
+	if (bFastForward)
+	{
+		// Uncapped, steps until this frame's share of wall time is spent
+		const double EndWallSeconds = FPlatformTime::Seconds() + FastForwardBudgetMs / 1000.0;
+		do
+		{
+			Step();
+		}
+		while (FPlatformTime::Seconds() < EndWallSeconds);
+	}
+	else
+	{
+		// Real frame time, the world's own time dilation must not scale it a second time
+		Accumulator += static_cast<double>(GetWorld()->DeltaRealTimeSeconds) * TimeScale;
+
+		// As many steps as the time scale asks for, always at least one, until the budget is spent
+		const double EndWallSeconds = FPlatformTime::Seconds() + StepBudgetMs / 1000.0;
+		int32 NumSteps = 0;
+		while (Accumulator >= FixedDeltaTime && (MaxSubstepsPerFrame <= 0 || NumSteps < MaxSubstepsPerFrame))
+		{
+			Accumulator -= FixedDeltaTime;
+			Step();
+			NumSteps++;
+
+			if (FPlatformTime::Seconds() >= EndWallSeconds)
+			{
+				break;
+			}
+		}
+
+		// Carrying time the budget could not cover would only make every following frame longer
+		if (Accumulator >= FixedDeltaTime)
+		{
+			const double Kept = FMath::Fmod(Accumulator, static_cast<double>(FixedDeltaTime));
+			DroppedSeconds += Accumulator - Kept;
+			WindowDroppedSeconds += Accumulator - Kept;
+			Accumulator = Kept;
+		}
+	}
+
+	const double WallSeconds = FPlatformTime::Seconds();
+	if (WallSeconds - WindowStartWallSeconds >= 1.0)
+	{
+		AchievedTimeScale = static_cast<float>((SimulationSeconds - WindowStartSimulationSeconds) / (WallSeconds - WindowStartWallSeconds));
+		WindowStartWallSeconds = WallSeconds;
+		WindowStartSimulationSeconds = SimulationSeconds;
+
+		if (bFastForward)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Fast-forward: %.1f simulated seconds per wall second, %.0f s simulated"), AchievedTimeScale, SimulationSeconds);
+		}
+		else if (WindowDroppedSeconds > 0.0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Simulation clock dropped %.1f simulated seconds in the last second, reaching %.1fx of the requested %.1fx. Raise the step budget of %.1f ms or lower the time scale"),
+				WindowDroppedSeconds, AchievedTimeScale, TimeScale, StepBudgetMs);
+		}
+		WindowDroppedSeconds = 0.0;
+	}
+
+	ApplyWorldTimeDilation();
+}
+
+void UEcosystemClockSubsystem::Step()
+{
+	SimulationSeconds += FixedDeltaTime;
+	OnSimulationStep.Broadcast(FixedDeltaTime);
+}
+
+void UEcosystemClockSubsystem::ApplyWorldTimeDilation()
+{
+	// Engine-driven movement follows the ecosystem only as far as it stays stable
+	const float TimeDilation = bFastForward ? MaxWorldTimeDilation : FMath::Min(TimeScale, MaxWorldTimeDilation);
+
+	AWorldSettings* WorldSettings = GetWorld()->GetWorldSettings();
+	if (WorldSettings && WorldSettings->TimeDilation != TimeDilation)
+	{
+		WorldSettings->SetTimeDilation(TimeDilation);
+	}
+}
@@ -0,0 +1,186 @@
+#include "EcosystemHeadlessCommandlet.h"
+#include "IslandModel.h"
+#include "GeneticSelection.h"
+#include "Misc/FileHelper.h"
+
+UEcosystemHeadlessCommandlet::UEcosystemHeadlessCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UEcosystemHeadlessCommandlet::Main(const FString& Params)
+{
+	int32 Generations = 1000;
+	int32 ReportEvery = 100;
+	int32 Seed = 1;
+	int32 NumIslands = 1;
+	float TargetFitness = 0.0f;
+	FString SelectionName;
+	FString MutationName;
+	FString TopologyName;
+	FString CsvPath;
+
+	FHeadlessEvolutionParams EvolutionParams;
+	EvolutionParams.Breeding.PopulationSize = 50;
+
+	FParse::Value(*Params, TEXT("Generations="), Generations);
+	FParse::Value(*Params, TEXT("Population="), EvolutionParams.Breeding.PopulationSize);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("MutationRate="), EvolutionParams.Breeding.MutationRate);
+	FParse::Value(*Params, TEXT("MutationStrength="), EvolutionParams.Breeding.MutationStrength);
+	FParse::Value(*Params, TEXT("ElitePercentage="), EvolutionParams.Breeding.ElitePercentage);
+	FParse::Value(*Params, TEXT("TournamentSize="), EvolutionParams.Breeding.TournamentSize);
+	FParse::Value(*Params, TEXT("MinPopulation="), EvolutionParams.MinPopulation);
+	FParse::Value(*Params, TEXT("MaxPopulation="), EvolutionParams.MaxPopulation);
+	FParse::Value(*Params, TEXT("TimeLimit="), EvolutionParams.GenerationTimeLimit);
+	FParse::Value(*Params, TEXT("TimeStep="), EvolutionParams.TimeStep);
+	FParse::Value(*Params, TEXT("ReportEvery="), ReportEvery);
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+	FParse::Value(*Params, TEXT("Islands="), NumIslands);
+	FParse::Value(*Params, TEXT("TargetFitness="), TargetFitness);
+	FParse::Value(*Params, TEXT("Novelty="), EvolutionParams.Novelty.Weight);
+	FParse::Value(*Params, TEXT("NoveltyNeighbors="), EvolutionParams.Novelty.NumNeighbors);
+	FParse::Value(*Params, TEXT("NoveltyArchiveFraction="), EvolutionParams.Novelty.ArchiveFraction);
+	FParse::Value(*Params, TEXT("Species="), EvolutionParams.Speciation.NumSpecies);
+	EvolutionParams.Speciation.bFitnessSharing = !FParse::Param(*Params, TEXT("NoFitnessSharing"));
+
+	FMigrationParams Migration;
+	FParse::Value(*Params, TEXT("MigrationInterval="), Migration.Interval);
+	FParse::Value(*Params, TEXT("Migrants="), Migration.MigrantCount);
+
+	if (FParse::Value(*Params, TEXT("Selection="), SelectionName))
+	{
+		const int64 Strategy = StaticEnum<ESelectionStrategy>()->GetValueByNameString(SelectionName);
+		if (Strategy == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unknown selection strategy %s"), *SelectionName);
+			return 1;
+		}
+		EvolutionParams.Breeding.SelectionStrategy = static_cast<ESelectionStrategy>(Strategy);
+	}
+
+	if (FParse::Value(*Params, TEXT("Mutation="), MutationName))
+	{
+		const int64 Mode = StaticEnum<EMutationMode>()->GetValueByNameString(MutationName);
+		if (Mode == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unknown mutation mode %s"), *MutationName);
+			return 1;
+		}
+		EvolutionParams.Breeding.MutationMode = static_cast<EMutationMode>(Mode);
+	}
+
+	if (FParse::Value(*Params, TEXT("Topology="), TopologyName))
+	{
+		const int64 Topology = StaticEnum<EMigrationTopology>()->GetValueByNameString(TopologyName);
+		if (Topology == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unknown migration topology %s"), *TopologyName);
+			return 1;
+		}
+		Migration.Topology = static_cast<EMigrationTopology>(Topology);
+	}
+
+	EvolutionParams.Breeding.Seed = static_cast<uint64>(Seed);
+	EvolutionParams.Novelty.Seed = static_cast<uint64>(Seed);
+	EvolutionParams.Speciation.Seed = static_cast<uint64>(Seed);
+	EvolutionParams.TimeStep = FMath::Max(EvolutionParams.TimeStep, KINDA_SMALL_NUMBER);
+	ReportEvery = FMath::Max(1, ReportEvery);
+	NumIslands = FMath::Max(1, NumIslands);
+
+	// The population is split evenly, every island uses the command line GA settings
+	TArray<FIslandConfig> Islands;
+	for (int32 Island = 0; Island < NumIslands; Island++)
+	{
+		FIslandConfig& Config = Islands.AddDefaulted_GetRef();
+		Config.PopulationSize = FMath::Max(1, EvolutionParams.Breeding.PopulationSize / NumIslands);
+		Config.MutationRate = EvolutionParams.Breeding.MutationRate;
+		Config.MutationStrength = EvolutionParams.Breeding.MutationStrength;
+		Config.MutationMode = EvolutionParams.Breeding.MutationMode;
+		Config.ElitePercentage = EvolutionParams.Breeding.ElitePercentage;
+		Config.SelectionStrategy = EvolutionParams.Breeding.SelectionStrategy;
+		Config.TournamentSize = EvolutionParams.Breeding.TournamentSize;
+	}
+
+	FIslandEvolution Evolution(EvolutionParams, Islands, Migration);
+	Evolution.InitializeRandom();
+
+	TArray<FString> CsvLines;
+	if (!CsvPath.IsEmpty())
+	{
+		CsvLines.Add(TEXT("Generation,Population,Births,Deaths,AverageFitness,MaxFitness,P10Fitness,MedianFitness,P90Fitness,SimulatedSeconds"));
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Headless evolution: %d generations, population %d on %d islands, seed %d"), Generations, EvolutionParams.Breeding.PopulationSize, NumIslands, Seed);
+
+	const double StartTime = FPlatformTime::Seconds();
+	FHeadlessGenerationStats BestStats;
+	int32 TargetGeneration = INDEX_NONE;
+	double SimulatedSeconds = 0.0;
+
+	for (int32 i = 0; i < Generations; i++)
+	{
+		const FHeadlessGenerationStats Stats = Evolution.RunGeneration();
+		SimulatedSeconds += Stats.SimulatedSeconds;
+
+		if (Stats.MaxFitness > BestStats.MaxFitness)
+		{
+			BestStats = Stats;
+		}
+
+		if (TargetFitness > 0.0f && TargetGeneration == INDEX_NONE && Stats.MaxFitness >= TargetFitness)
+		{
+			TargetGeneration = Stats.Generation;
+		}
+
+		const FQuantileSummary Fitness = Stats.Sketch.Fitness.GetSummary();
+
+		if (!CsvPath.IsEmpty())
+		{
+			CsvLines.Add(FString::Printf(TEXT("%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.2f"), Stats.Generation, Stats.Population, Stats.Births, Stats.Deaths,
+				Stats.AverageFitness, Stats.MaxFitness, Fitness.P10, Fitness.Median, Fitness.P90, Stats.SimulatedSeconds));
+		}
+
+		if ((i + 1) % ReportEvery == 0)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Generation %d - Population: %d, Avg Fitness: %.2f, Median Fitness: %.2f, Max Fitness: %.2f"),
+				Stats.Generation, Stats.Population, Stats.AverageFitness, Fitness.Median, Stats.MaxFitness);
+		}
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogTemp, Display, TEXT("Finished %d generations in %.2f s (%.0f generations per minute), best fitness %.2f in generation %d"),
+		Generations, ElapsedSeconds, Generations / FMath::Max(ElapsedSeconds, 1e-6) * 60.0, BestStats.MaxFitness, BestStats.Generation);
+	UE_LOG(LogTemp, Display, TEXT("Simulated %.0f s, %.1f simulated seconds per wall second"), SimulatedSeconds, SimulatedSeconds / FMath::Max(ElapsedSeconds, 1e-6));
+
+	if (TargetFitness > 0.0f)
+	{
+		if (TargetGeneration != INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Target fitness %.2f reached in generation %d"), TargetFitness, TargetGeneration);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Display, TEXT("Target fitness %.2f not reached in %d generations"), TargetFitness, Generations);
+		}
+	}
+
+	const FGenomeCacheStats CacheStats = Evolution.GetFitnessCacheStats();
+	UE_LOG(LogTemp, Display, TEXT("Genome evaluations: %d cached, %d computed (%.1f%% hit rate)"), CacheStats.Hits, CacheStats.Misses, CacheStats.HitRate * 100.0f);
+
+	if (EvolutionParams.Novelty.IsEnabled())
+	{
+		UE_LOG(LogTemp, Display, TEXT("Novelty archive: %d genomes"), Evolution.GetNoveltyArchiveSize());
+	}
+
+	if (!CsvPath.IsEmpty() && !FFileHelper::SaveStringArrayToFile(CsvLines, *CsvPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to write %s"), *CsvPath);
+		return 1;
+	}
+
+	return 0;
+}
@@ -1,27 +1,70 @@
 #include "EcosystemManager.h"
 #include "Creature.h"
+#include "GenePool.h"
+#include "GenerationBreeder.h"
+#include "CreaturePoolSubsystem.h"
+#include "EcosystemClockSubsystem.h"
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
 
 AEcosystemManager::AEcosystemManager()
 {
 	PrimaryActorTick.bCanEverTick = true;
-	PrimaryActorTick.TickInterval = 0.1f; // Update every 100ms for performance
+	PrimaryActorTick.TickInterval = DefaultTickInterval; // Update every 100ms for performance
 }
 
 void AEcosystemManager::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (UCreaturePoolSubsystem* Pool = GetWorld()->GetSubsystem<UCreaturePoolSubsystem>())
+	{
+		Pool->SetMaxPooledCreatures(MaxPooledCreatures);
+	}
+
+	FitnessCache.SetCapacity(FitnessCacheCapacity);
+
+	// Generation time runs on the fixed simulation clock, not on frames
+	if (UEcosystemClockSubsystem* Clock = GetWorld()->GetSubsystem<UEcosystemClockSubsystem>())
+	{
+		Clock->OnSimulationStep.AddUObject(this, &AEcosystemManager::StepSimulation);
+	}
 	
 	InitializeEcosystem();
 }
 
+void AEcosystemManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	WaitForBreeding();
+	WaitForSave();
+	HistoryLog.Close();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AEcosystemManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	CurrentGenerationTime += DeltaTime;
+	// No creatures exist in headless mode, only the genetic algorithm runs
+	if (bHeadlessMode)
+	{
+		if (HeadlessEvolution)
+		{
+			RunHeadlessGenerations(HeadlessGenerationsPerTick);
+		}
+		return;
+	}
+
+	// Materialize the next generation once its genes are ready
+	if (bGenerationInProgress && BreedingTask.IsCompleted())
+	{
+		FinishGeneration();
+	}
+
+	ProcessSpawnQueue();
 
 	// Update stats periodically
 	if (GetWorld()->GetTimeSeconds() - LastStatsUpdateTime > StatsUpdateInterval)
@@ -41,46 +84,223 @@ void AEcosystemManager::Tick(float DeltaTime)
 	CleanupDeadCreatures();
 }
 
+void AEcosystemManager::StepSimulation(float StepSeconds)
+{
+	if (!bHeadlessMode)
+	{
+		CurrentGenerationTime += StepSeconds;
+	}
+}
+
 void AEcosystemManager::InitializeEcosystem()
 {
-	if (!CreatureClass)
+	if (!CreatureClass && !bHeadlessMode)
 	{
 		UE_LOG(LogTemp, Error, TEXT("CreatureClass not set in EcosystemManager!"));
 		return;
 	}
 
 	// Clear existing data
-	ActiveCreatures.Empty();
-	CreatureHistory.Empty();
-	PendingOffspring.Empty();
+	WaitForBreeding();
+	ClearSpawnQueue();
+	ReleaseAllCreatures();
+	TopPerformerHeap.Empty();
+	HeadlessEvolution.Reset();
+	NoveltyArchives.Reset();
+	Speciations.Reset();
+	Lineage.Reset();
+	GenerationSketch.Reset();
+	QuantileHistory.Reset();
 
 	// Reset stats
 	CurrentStats = FPopulationStats();
+	SpawnQueueStats = FSpawnQueueStats();
+	TotalSpawnLatency = 0.0;
 	CurrentGenerationTime = 0.0f;
 
-	// Spawn initial population with random genes
-	for (int32 i = 0; i < InitialPopulation; i++)
+	// Reset random streams
+	ActiveSeed = RandomSeed != 0 ? static_cast<uint64>(RandomSeed) : FPlatformTime::Cycles64();
+	NextCreatureId = 0;
+
+	OpenHistoryLog();
+
+	// Same initial genomes as the spawned population, but kept as data
+	if (bHeadlessMode)
+	{
+		RunHeadlessGenerations(0);
+		UE_LOG(LogTemp, Warning, TEXT("Headless ecosystem initialized on %d islands (seed %llu)"), GetIslandCount(), ActiveSeed);
+		return;
+	}
+
+	// Queue initial population with random genes, each island draws from its own streams
+	const TArray<FIslandConfig> IslandConfigs = GetIslandConfigs();
+	TArray<FGenePool> InitialGenes;
+	InitialGenes.SetNum(IslandConfigs.Num());
+
+	int32 TotalQueued = 0;
+	for (int32 Island = 0; Island < IslandConfigs.Num(); Island++)
 	{
-		FCreatureGenes RandomGenes = FCreatureGenes::GenerateRandom();
-		FVector SpawnLocation = GetRandomSpawnLocation();
-		SpawnCreature(RandomGenes, SpawnLocation);
+		const FRandomStreamBatch Streams(FIslandModel::GetIslandSeed(ActiveSeed, Island), CurrentStats.Generation, 0, ERandomStreamPurpose::Genesis);
+		InitialGenes[Island].GenerateRandomBatch(IslandConfigs[Island].PopulationSize, Streams);
+		TotalQueued += InitialGenes[Island].Num();
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("Ecosystem initialized with %d creatures"), InitialPopulation);
+	QueueIslandPopulations(InitialGenes, {});
+
+	UE_LOG(LogTemp, Warning, TEXT("Ecosystem initialized, %d creatures queued on %d islands (seed %llu)"), TotalQueued, IslandConfigs.Num(), ActiveSeed);
 }
 
 void AEcosystemManager::ResetEcosystem()
 {
-	// Destroy all existing creatures
-	for (ACreature* Creature : ActiveCreatures)
+	// Return all existing creatures to the pool
+	ReleaseAllCreatures();
+
+	InitializeEcosystem();
+}
+
+void AEcosystemManager::RunHeadlessGenerations(int32 Count)
+{
+	if (!HeadlessEvolution)
 	{
-		if (IsValid(Creature))
+		WaitForBreeding();
+		HeadlessEvolution = MakeUnique<FIslandEvolution>(MakeHeadlessParams(), GetIslandConfigs(), MakeMigrationParams());
+
+		// Continue from the creatures in the world when there are any
+		TArray<FGenePool> Populations;
+		TArray<TArray<float>> Fitness;
+		TArray<FFitnessObjectives> Objectives;
+		GatherPopulationSnapshot(Populations, Fitness, Objectives);
+		if (!ActiveCreatures.IsEmpty())
 		{
-			Creature->Destroy();
+			HeadlessEvolution->Initialize(MoveTemp(Populations), CurrentStats.Generation);
+		}
+		else
+		{
+			HeadlessEvolution->InitializeRandom();
 		}
+
+		HeadlessEvolution->OnCreatureDeath = [this](const FCreatureRecord& Record)
+		{
+			HistoryLog.Add(Record);
+			RecordTopPerformer(Record);
+		};
 	}
 
-	InitializeEcosystem();
+	for (int32 i = 0; i < Count; i++)
+	{
+		const FHeadlessGenerationStats Stats = HeadlessEvolution->RunGeneration();
+
+		CurrentStats.Generation = HeadlessEvolution->GetGeneration();
+		CurrentStats.TotalPopulation = Stats.Population;
+		CurrentStats.AverageFitness = Stats.AverageFitness;
+		CurrentStats.MaxFitness = Stats.MaxFitness;
+		CurrentStats.DominantGenes = Stats.BestGenes;
+
+		const FGenerationQuantiles& Quantiles = QuantileHistory.Add_GetRef(Stats.Sketch.GetQuantiles(Stats.Generation));
+		CurrentStats.FitnessQuantiles = Quantiles.Fitness;
+		CurrentStats.Species = Stats.Species;
+
+		OnGenerationComplete.Broadcast(CurrentStats.Generation);
+	}
+
+	// Trait counts of the genomes that make up the next generation
+	FMemory::Memzero(CurrentStats.MovementTypeDistribution);
+	FMemory::Memzero(CurrentStats.AggressionDistribution);
+	for (int32 Island = 0; Island < HeadlessEvolution->NumIslands(); Island++)
+	{
+		const FGenePool& Population = HeadlessEvolution->GetPopulation(Island);
+		for (int32 i = 0; i < Population.Num(); i++)
+		{
+			CurrentStats.MovementTypeDistribution[Population.MovementTypes[i]]++;
+			CurrentStats.AggressionDistribution[Population.AggressionLevels[i]]++;
+		}
+	}
+
+	if (bHeadlessMode || !CreatureClass)
+	{
+		return;
+	}
+
+	// Bring the evolved generation back into the world, each island in its own sector
+	ClearSpawnQueue();
+	ReleaseAllCreatures();
+
+	TArray<FGenePool> Populations;
+	for (int32 Island = 0; Island < HeadlessEvolution->NumIslands(); Island++)
+	{
+		Populations.Add(HeadlessEvolution->GetPopulation(Island));
+	}
+
+	QueueIslandPopulations(Populations, {});
+
+	HeadlessEvolution.Reset();
+	CurrentGenerationTime = 0.0f;
+}
+
+FHeadlessEvolutionParams AEcosystemManager::MakeHeadlessParams() const
+{
+	FHeadlessEvolutionParams Params;
+	Params.MinPopulation = MinPopulation;
+	Params.MaxPopulation = MaxPopulation;
+	Params.GenerationTimeLimit = GenerationTimeLimit;
+	Params.Breeding.PopulationSize = InitialPopulation;
+	Params.Breeding.MutationRate = MutationRate;
+	Params.Breeding.MutationStrength = MutationStrength;
+	Params.Breeding.MutationMode = MutationMode;
+	Params.Breeding.ElitePercentage = ElitePercentage;
+	Params.Breeding.SelectionStrategy = SelectionStrategy;
+	Params.Breeding.TournamentSize = TournamentSize;
+	Params.Breeding.Seed = ActiveSeed;
+	Params.Novelty = MakeNoveltyParams();
+	Params.Speciation = MakeSpeciationParams();
+	return Params;
+}
+
+FNoveltySearchParams AEcosystemManager::MakeNoveltyParams() const
+{
+	FNoveltySearchParams Params;
+	Params.Weight = NoveltyWeight;
+	Params.NumNeighbors = NoveltyNeighbors;
+	Params.ArchiveFraction = NoveltyArchiveFraction;
+	Params.Seed = ActiveSeed;
+	return Params;
+}
+
+FSpeciationParams AEcosystemManager::MakeSpeciationParams() const
+{
+	FSpeciationParams Params;
+	Params.NumSpecies = NumSpecies;
+	Params.bFitnessSharing = bSpeciesFitnessSharing;
+	Params.Seed = ActiveSeed;
+	return Params;
+}
+
+TArray<FIslandConfig> AEcosystemManager::GetIslandConfigs() const
+{
+	if (Islands.Num() > 0)
+	{
+		return Islands;
+	}
+
+	// A single island with the manager's settings is the classic panmictic population
+	FIslandConfig Config;
+	Config.PopulationSize = InitialPopulation;
+	Config.MutationRate = MutationRate;
+	Config.MutationStrength = MutationStrength;
+	Config.MutationMode = MutationMode;
+	Config.ElitePercentage = ElitePercentage;
+	Config.SelectionStrategy = SelectionStrategy;
+	Config.TournamentSize = TournamentSize;
+	return { Config };
+}
+
+FMigrationParams AEcosystemManager::MakeMigrationParams() const
+{
+	FMigrationParams Params;
+	Params.Topology = MigrationTopology;
+	Params.Interval = MigrationInterval;
+	Params.MigrantCount = MigrantCount;
+	return Params;
 }
 
 void AEcosystemManager::AdvanceGeneration()
@@ -95,48 +315,137 @@ void AEcosystemManager::AdvanceGeneration()
 
 	UE_LOG(LogTemp, Warning, TEXT("Advancing to Generation %d"), CurrentStats.Generation);
 
-	// Get top performers for the next generation
-	TArray<FCreatureGenes> ParentGenes = SelectParentsForReproduction();
-	
-	// Destroy current population
-	for (ACreature* Creature : ActiveCreatures)
+	// Snapshot the current population on the game thread, split by island sector
+	TArray<FGenePool> Populations;
+	TArray<TArray<float>> Fitness;
+	TArray<FFitnessObjectives> Objectives;
+	GatherPopulationSnapshot(Populations, Fitness, Objectives);
+
+	// The survivors close the sketch of the generation that just ended
+	for (int32 Island = 0; Island < Populations.Num(); Island++)
 	{
-		if (IsValid(Creature))
+		for (int32 Row = 0; Row < Populations[Island].Num(); Row++)
 		{
-			Creature->Destroy();
+			GenerationSketch.Add(Populations[Island], Row, Fitness[Island][Row]);
 		}
 	}
-	ActiveCreatures.Empty();
 
-	// Create new generation
-	int32 EliteCount = FMath::RoundToInt(ParentGenes.Num() * ElitePercentage);
-	
-	// Keep elite unchanged
-	for (int32 i = 0; i < EliteCount; i++)
+	const FGenerationQuantiles& Quantiles = QuantileHistory.Add_GetRef(GenerationSketch.GetQuantiles(CurrentStats.Generation - 1));
+	CurrentStats.FitnessQuantiles = Quantiles.Fitness;
+	GenerationSketch.Reset();
+
+	UE_LOG(LogTemp, Warning, TEXT("Generation %d Fitness - P10: %.2f, P25: %.2f, Median: %.2f, P75: %.2f, P90: %.2f over %d creatures"), Quantiles.Generation,
+		Quantiles.Fitness.P10, Quantiles.Fitness.P25, Quantiles.Fitness.Median, Quantiles.Fitness.P75, Quantiles.Fitness.P90, Quantiles.Fitness.Count);
+
+	const TArray<FIslandConfig> IslandConfigs = GetIslandConfigs();
+	PendingEliteCounts.SetNum(IslandConfigs.Num());
+	for (int32 Island = 0; Island < IslandConfigs.Num(); Island++)
 	{
-		FVector SpawnLocation = GetRandomSpawnLocation();
-		SpawnCreature(ParentGenes[i], SpawnLocation);
+		const FBreedingParams Params = FIslandModel::MakeBreedingParams(IslandConfigs[Island], ActiveSeed, Island, CurrentStats.Generation);
+		PendingEliteCounts[Island] = FGenerationBreeder::GetEliteCount(Fitness[Island].Num(), Params);
 	}
 
-	// Create offspring from crossover and mutation
-	while (ActiveCreatures.Num() < InitialPopulation)
+	// Each island keeps its own archive, as the headless islands do
+	const FNoveltySearchParams Novelty = MakeNoveltyParams();
+	TArray<TSharedPtr<FNoveltyArchive>> TaskArchives;
+	if (Novelty.IsEnabled())
 	{
-		// Select two random parents
-		int32 Parent1Index = FMath::RandRange(0, ParentGenes.Num() - 1);
-		int32 Parent2Index = FMath::RandRange(0, ParentGenes.Num() - 1);
+		if (NoveltyArchives.Num() != IslandConfigs.Num())
+		{
+			NoveltyArchives.Reset();
+			for (int32 Island = 0; Island < IslandConfigs.Num(); Island++)
+			{
+				NoveltyArchives.Add(MakeShared<FNoveltyArchive>(Novelty));
+			}
+		}
+
+		for (const TSharedPtr<FNoveltyArchive>& Archive : NoveltyArchives)
+		{
+			Archive->SetParams(Novelty);
+		}
+
+		TaskArchives = NoveltyArchives;
+	}
 
-		// Ensure different parents
-		while (Parent2Index == Parent1Index && ParentGenes.Num() > 1)
+	// Species centroids carry over per island in the same way
+	const FSpeciationParams Speciation = MakeSpeciationParams();
+	if (!Speciation.IsEnabled())
+	{
+		Speciations.Reset();
+	}
+	else if (Speciations.Num() != IslandConfigs.Num())
+	{
+		Speciations.Reset();
+		for (int32 Island = 0; Island < IslandConfigs.Num(); Island++)
 		{
-			Parent2Index = FMath::RandRange(0, ParentGenes.Num() - 1);
+			Speciations.Add(MakeShared<FSpeciation>(Speciation));
 		}
+	}
+
+	for (const TSharedPtr<FSpeciation>& Species : Speciations)
+	{
+		Species->SetParams(Speciation);
+	}
 
-		// Create offspring
-		FCreatureGenes OffspringGenes = FCreatureGenes::Crossover(ParentGenes[Parent1Index], ParentGenes[Parent2Index]);
-		OffspringGenes.Mutate(MutationRate, MutationStrength);
+	// Selection, crossover, mutation and migration run off the game thread, FinishGeneration spawns the result
+	BreedingTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Populations = MoveTemp(Populations), Fitness = MoveTemp(Fitness), Objectives = MoveTemp(Objectives), Archives = MoveTemp(TaskArchives), Clusterings = Speciations, IslandConfigs, Migration = MakeMigrationParams(), Seed = ActiveSeed, Generation = CurrentStats.Generation]() mutable
+		{
+			// Species stats are taken from the raw fitness, before sharing and novelty reshape it
+			for (int32 Island = 0; Island < Clusterings.Num(); Island++)
+			{
+				Clusterings[Island]->ClusterAndShare(Populations[Island], Fitness[Island]);
+			}
+
+			for (int32 Island = 0; Island < Archives.Num(); Island++)
+			{
+				Archives[Island]->ScoreAndArchive(Populations[Island], Fitness[Island]);
+			}
+
+			TArray<FGenePool> NextGenerations;
+			FIslandModel::BreedIslands(Populations, Fitness, Objectives, IslandConfigs, Migration, Seed, Generation, NextGenerations);
+			return NextGenerations;
+		});
+}
+
+void AEcosystemManager::FinishGeneration()
+{
+	const TArray<FGenePool>& NextGenerations = BreedingTask.GetResult();
+
+	// Return current population to the pool, births still queued belong to it
+	ClearSpawnQueue();
+	ReleaseAllCreatures();
+
+	if (UCreaturePoolSubsystem* Pool = GetWorld()->GetSubsystem<UCreaturePoolSubsystem>())
+	{
+		Pool->NotifyGenerationComplete();
+		const FCreaturePoolStats PoolStats = Pool->GetPoolStats();
+		UE_LOG(LogTemp, Warning, TEXT("Generation %d GC - %.2f ms, average %.2f ms per generation (pooling %s)"),
+			CurrentStats.Generation - 1, PoolStats.LastGenerationGarbageCollectionMs, PoolStats.GarbageCollectionMsPerGeneration,
+			PoolStats.bPoolingEnabled ? TEXT("on") : TEXT("off"));
+	}
+
+	QueueIslandPopulations(NextGenerations, PendingEliteCounts);
+
+	BreedingTask = {};
+
+	// The task is done with the clusterings
+	CurrentStats.Species.Reset();
+	int32 LargestSpecies = 0;
+	for (int32 Island = 0; Island < Speciations.Num(); Island++)
+	{
+		for (FSpeciesStats Species : Speciations[Island]->GetStats())
+		{
+			Species.Island = Island;
+			LargestSpecies = FMath::Max(LargestSpecies, Species.Size);
+			CurrentStats.Species.Add(MoveTemp(Species));
+		}
+	}
 
-		FVector SpawnLocation = GetRandomSpawnLocation();
-		SpawnCreature(OffspringGenes, SpawnLocation);
+	if (CurrentStats.Species.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Generation %d Species - %d over %d islands, largest %d creatures"),
+			CurrentStats.Generation - 1, CurrentStats.Species.Num(), Speciations.Num(), LargestSpecies);
 	}
 
 	// Reset generation timer
@@ -146,6 +455,178 @@ void AEcosystemManager::AdvanceGeneration()
 	OnGenerationComplete.Broadcast(CurrentStats.Generation);
 }
 
+void AEcosystemManager::QueueIslandPopulations(TConstArrayView<FGenePool> IslandPopulations, TConstArrayView<int32> EliteCounts)
+{
+	// Elites lead each island's gene pool and spawn first
+	for (int32 Island = 0; Island < IslandPopulations.Num(); Island++)
+	{
+		const FGenePool& Population = IslandPopulations[Island];
+		const int32 EliteCount = EliteCounts.IsValidIndex(Island) ? EliteCounts[Island] : 0;
+
+		for (int32 i = 0; i < Population.Num(); i++)
+		{
+			const int32 CreatureId = NextCreatureId++;
+			FSimulationRandomStream SpawnStream(ActiveSeed, CreatureId, CurrentStats.Generation, ERandomStreamPurpose::Spawn);
+			FVector SpawnLocation = GetRandomSpawnLocation(SpawnStream, Island);
+			QueueSpawnWithId(Population.Get(i), SpawnLocation, i < EliteCount ? ESpawnPriority::Elite : ESpawnPriority::Offspring,
+				CreatureId, Population.Lineages[0][i], Population.Lineages[1][i]);
+		}
+	}
+}
+
+void AEcosystemManager::QueueSpawn(const FCreatureGenes& Genes, const FVector& Location, ESpawnPriority Priority)
+{
+	QueueSpawnWithId(Genes, Location, Priority, NextCreatureId++, FLineageArena::InvalidId, FLineageArena::InvalidId);
+}
+
+void AEcosystemManager::QueueSpawnWithId(const FCreatureGenes& Genes, const FVector& Location, ESpawnPriority Priority, int32 CreatureId, uint32 Parent1, uint32 Parent2)
+{
+	FPendingSpawn Pending{ Genes, Location, FPlatformTime::Seconds() };
+	Pending.CreatureId = CreatureId;
+	Pending.Parents[0] = Parent1;
+	Pending.Parents[1] = Parent2;
+	EnqueueSpawn(MoveTemp(Pending), Priority);
+}
+
+void AEcosystemManager::EnqueueSpawn(FPendingSpawn&& Pending, ESpawnPriority Priority)
+{
+	SpawnQueues[(int32)Priority].Add(MoveTemp(Pending));
+	PendingSpawnCount++;
+	SpawnQueueStats.QueueDepth = PendingSpawnCount;
+
+	// Tick every frame until the queue is drained
+	SetActorTickInterval(0.0f);
+}
+
+void AEcosystemManager::ProcessSpawnQueue()
+{
+	SpawnQueueStats.SpawnedLastFrame = 0;
+
+	if (PendingSpawnCount == 0)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = SpawnBudgetMs / 1000.0;
+
+	for (int32 Priority = 0; Priority < (int32)ESpawnPriority::Count; Priority++)
+	{
+		TArray<FPendingSpawn>& Queue = SpawnQueues[Priority];
+		int32& Head = SpawnQueueHeads[Priority];
+
+		while (Head < Queue.Num())
+		{
+			// Always make progress, then stop once the budget is spent
+			const double Now = FPlatformTime::Seconds();
+			if (SpawnQueueStats.SpawnedLastFrame > 0 && Now - StartTime >= BudgetSeconds)
+			{
+				break;
+			}
+
+			// Copied, a spawned creature can queue a birth and grow the queues
+			const FPendingSpawn Pending = Queue[Head++];
+			PendingSpawnCount--;
+
+			const double Latency = Now - Pending.QueueTime;
+			TotalSpawnLatency += Latency;
+			SpawnQueueStats.MaxLatencyMs = FMath::Max(SpawnQueueStats.MaxLatencyMs, static_cast<float>(Latency * 1000.0));
+
+			if (Pending.bRestoreState)
+			{
+				if (ACreature* Creature = SpawnCreatureWithId(Pending.Genes, Pending.Location, Pending.CreatureId, Pending.Parents[0], Pending.Parents[1], Pending.LineageId))
+				{
+					Creature->InitializeRandomStream(Pending.CreatureId, Pending.RandomStream);
+					Creature->RestoreLifeState(Pending.LifeState);
+				}
+			}
+			else if (CreatureClass)
+			{
+				SpawnCreatureWithId(Pending.Genes, Pending.Location, Pending.CreatureId, Pending.Parents[0], Pending.Parents[1]);
+			}
+
+			SpawnQueueStats.SpawnedLastFrame++;
+			SpawnQueueStats.TotalSpawned++;
+		}
+
+		if (Head == Queue.Num())
+		{
+			Queue.Reset();
+			Head = 0;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	SpawnQueueStats.QueueDepth = PendingSpawnCount;
+	SpawnQueueStats.AverageLatencyMs = static_cast<float>(TotalSpawnLatency * 1000.0 / FMath::Max(1, SpawnQueueStats.TotalSpawned));
+
+	if (PendingSpawnCount == 0)
+	{
+		SetActorTickInterval(DefaultTickInterval);
+	}
+}
+
+void AEcosystemManager::ClearSpawnQueue()
+{
+	for (int32 Priority = 0; Priority < (int32)ESpawnPriority::Count; Priority++)
+	{
+		SpawnQueues[Priority].Reset();
+		SpawnQueueHeads[Priority] = 0;
+	}
+
+	PendingSpawnCount = 0;
+	SpawnQueueStats.QueueDepth = 0;
+	SetActorTickInterval(DefaultTickInterval);
+}
+
+void AEcosystemManager::ReleaseAllCreatures()
+{
+	UCreaturePoolSubsystem* Pool = GetWorld()->GetSubsystem<UCreaturePoolSubsystem>();
+
+	for (ACreature* Creature : ActiveCreatures)
+	{
+		if (!IsValid(Creature))
+		{
+			continue;
+		}
+
+		if (Pool)
+		{
+			Pool->ReleaseCreature(Creature);
+		}
+		else
+		{
+			Creature->Destroy();
+		}
+	}
+
+	ActiveCreatures.Empty();
+	Aggregates.Reset();
+	DominantCreature = nullptr;
+}
+
+void AEcosystemManager::WaitForSave()
+{
+	if (SaveTask.IsValid())
+	{
+		SaveTask.Wait();
+		SaveTask = {};
+	}
+}
+
+void AEcosystemManager::WaitForBreeding()
+{
+	if (bGenerationInProgress)
+	{
+		BreedingTask.Wait();
+		BreedingTask = {};
+		bGenerationInProgress = false;
+	}
+}
+
 ACreature* AEcosystemManager::SpawnCreature(const FCreatureGenes& Genes, const FVector& Location)
 {
 	if (!CreatureClass)
@@ -153,24 +634,56 @@ ACreature* AEcosystemManager::SpawnCreature(const FCreatureGenes& Genes, const F
 		return nullptr;
 	}
 
+	return SpawnCreatureWithId(Genes, Location, NextCreatureId++, FLineageArena::InvalidId, FLineageArena::InvalidId);
+}
+
+ACreature* AEcosystemManager::SpawnCreatureWithId(const FCreatureGenes& Genes, const FVector& Location, int32 CreatureId, uint32 Parent1, uint32 Parent2, uint32 LineageId)
+{
+	if (!CreatureClass)
+	{
+		return nullptr;
+	}
+
 	FVector SpawnLocation = Location;
 	if (SpawnLocation == FVector::ZeroVector)
 	{
-		SpawnLocation = GetRandomSpawnLocation();
+		FSimulationRandomStream SpawnStream(ActiveSeed, CreatureId, CurrentStats.Generation, ERandomStreamPurpose::Spawn);
+		SpawnLocation = GetRandomSpawnLocation(SpawnStream);
 	}
 
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
-	ACreature* NewCreature = GetWorld()->SpawnActor<ACreature>(CreatureClass, SpawnLocation, FRotator::ZeroRotator, SpawnParams);
+	// Reuses a pooled creature when one is available
+	ACreature* NewCreature = nullptr;
+	const FTransform SpawnTransform(FRotator::ZeroRotator, SpawnLocation);
+	if (UCreaturePoolSubsystem* Pool = GetWorld()->GetSubsystem<UCreaturePoolSubsystem>())
+	{
+		NewCreature = Pool->AcquireCreature(CreatureClass, SpawnTransform);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		NewCreature = GetWorld()->SpawnActor<ACreature>(CreatureClass, SpawnTransform, SpawnParams);
+	}
 	
 	if (NewCreature)
 	{
-		NewCreature->InitializeWithGenes(Genes);
+		NewCreature->InitializeWithEvaluatedGenes(Genes, FitnessCache.Evaluate(Genes));
+		NewCreature->InitializeRandomStream(CreatureId, FSimulationRandomStream(ActiveSeed, CreatureId, CurrentStats.Generation, ERandomStreamPurpose::Creature));
+		// Only creatures that actually spawn get a lineage record, restored ones already have theirs
+		if (LineageId == FLineageArena::InvalidId)
+		{
+			LineageId = Lineage.Add(Parent1, Parent2, CurrentStats.Generation, UEcosystemClockSubsystem::GetSimulationSeconds(GetWorld()));
+		}
+		NewCreature->SetLineageId(LineageId);
 		NewCreature->OnCreatureDeath.AddDynamic(this, &AEcosystemManager::OnCreatureDeath);
 		NewCreature->OnCreatureReproduction.AddDynamic(this, &AEcosystemManager::OnCreatureReproduction);
+		NewCreature->OnFitnessChanged.AddUObject(this, &AEcosystemManager::OnCreatureFitnessChanged);
 		
 		ActiveCreatures.Add(NewCreature);
+
+		const FCreatureGenes& CreatureGenes = NewCreature->GetGenes();
+		Aggregates.Add(NewCreature, NewCreature->CalculateRawFitnessScore(), NewCreature->GetFitnessRate(),
+			CreatureGenes.MovementType, CreatureGenes.AggressionLevel, UEcosystemClockSubsystem::GetSimulationSeconds(GetWorld()));
 	}
 
 	return NewCreature;
@@ -181,14 +694,59 @@ void AEcosystemManager::RemoveCreature(ACreature* Creature)
 	if (Creature)
 	{
 		ActiveCreatures.Remove(Creature);
+		Aggregates.Remove(Creature);
 	}
 }
 
+void AEcosystemManager::OnCreatureFitnessChanged(ACreature* Creature)
+{
+	Aggregates.UpdateFitness(Creature, Creature->CalculateRawFitnessScore(), UEcosystemClockSubsystem::GetSimulationSeconds(GetWorld()));
+}
+
+FGenomeCacheStats AEcosystemManager::GetFitnessCacheStats() const
+{
+	FGenomeCacheStats Stats = FitnessCache.GetStats();
+
+	if (HeadlessEvolution)
+	{
+		const FGenomeCacheStats HeadlessStats = HeadlessEvolution->GetFitnessCacheStats();
+		Stats.Hits += HeadlessStats.Hits;
+		Stats.Misses += HeadlessStats.Misses;
+		Stats.Entries += HeadlessStats.Entries;
+		Stats.HitRate = Stats.Hits + Stats.Misses > 0 ? static_cast<float>(Stats.Hits) / (Stats.Hits + Stats.Misses) : 0.0f;
+	}
+
+	return Stats;
+}
+
+TMap<int32, int32> AEcosystemManager::GetLivingDescendantsPerFounder() const
+{
+	TArray<uint32> LivingIds;
+	LivingIds.Reserve(ActiveCreatures.Num());
+	for (const ACreature* Creature : ActiveCreatures)
+	{
+		if (IsValid(Creature))
+		{
+			LivingIds.Add(Creature->GetLineageId());
+		}
+	}
+
+	TMap<uint32, int32> Counts;
+	Lineage.CountDescendantsPerFounder(LivingIds, Counts);
+
+	TMap<int32, int32> Result;
+	Result.Reserve(Counts.Num());
+	for (const TPair<uint32, int32>& Pair : Counts)
+	{
+		Result.Add(static_cast<int32>(Pair.Key), Pair.Value);
+	}
+	return Result;
+}
+
 TArray<FCreatureGenes> AEcosystemManager::GetTopPerformers(int32 Count) const
 {
-	TArray<FCreatureRecord> SortedRecords = CreatureHistory;
-	
-	// Sort by fitness score
+	// Only the bounded heap is sorted, never the full history
+	TArray<FCreatureRecord> SortedRecords = TopPerformerHeap;
 	SortedRecords.Sort([](const FCreatureRecord& A, const FCreatureRecord& B)
 	{
 		return A.FitnessScore > B.FitnessScore;
@@ -203,38 +761,48 @@ TArray<FCreatureGenes> AEcosystemManager::GetTopPerformers(int32 Count) const
 	return TopGenes;
 }
 
-void AEcosystemManager::SaveGenerationData()
+void AEcosystemManager::RecordTopPerformer(const FCreatureRecord& Record)
 {
-	// This would typically save to a file or database
-	// For now, just log the data
-	UE_LOG(LogTemp, Warning, TEXT("Generation %d Data - Population: %d, Avg Fitness: %.2f, Max Fitness: %.2f"), 
-		CurrentStats.Generation, CurrentStats.TotalPopulation, CurrentStats.AverageFitness, CurrentStats.MaxFitness);
+	auto ByFitness = [](const FCreatureRecord& A, const FCreatureRecord& B)
+	{
+		return A.FitnessScore < B.FitnessScore;
+	};
+
+	if (TopPerformerHeap.Num() < TopPerformerCapacity)
+	{
+		TopPerformerHeap.HeapPush(Record, ByFitness);
+	}
+	else if (TopPerformerHeap.Num() > 0 && Record.FitnessScore > TopPerformerHeap.HeapTop().FitnessScore)
+	{
+		// Replace the weakest kept record
+		TopPerformerHeap.HeapPopDiscard(ByFitness, EAllowShrinking::No);
+		TopPerformerHeap.HeapPush(Record, ByFitness);
+	}
 }
 
-void AEcosystemManager::LoadGenerationData()
+FString AEcosystemManager::GetSnapshotPath() const
 {
-	// This would typically load from a file or database
-	UE_LOG(LogTemp, Warning, TEXT("LoadGenerationData - Not implemented yet"));
+	return FPaths::ProjectSavedDir() / TEXT("EcosystemSnapshots") / (SnapshotName + TEXT(".ecosnap"));
 }
 
-void AEcosystemManager::UpdatePopulationStats()
+void AEcosystemManager::SaveGenerationData()
 {
-	CurrentStats.TotalPopulation = ActiveCreatures.Num();
-
-	if (CurrentStats.TotalPopulation == 0)
+	// A generation still being bred is finished first so its genomes are saved
+	if (bGenerationInProgress)
 	{
-		return;
+		BreedingTask.Wait();
+		FinishGeneration();
 	}
 
-	// Calculate fitness statistics
-	float TotalFitness = 0.0f;
-	float MaxFitness = 0.0f;
-	FCreatureGenes BestGenes;
+	WaitForSave();
 
-	// Reset distribution maps
-	CurrentStats.MovementTypeDistribution.Empty();
-	CurrentStats.AggressionDistribution.Empty();
+	FEcosystemSnapshot Snapshot;
+	Snapshot.Header.Generation = CurrentStats.Generation;
+	Snapshot.Header.NextCreatureId = NextCreatureId;
+	Snapshot.Header.GenerationTime = CurrentGenerationTime;
+	Snapshot.Header.Seed = ActiveSeed;
 
+	Snapshot.Creatures.Reserve(ActiveCreatures.Num() + PendingSpawnCount);
 	for (ACreature* Creature : ActiveCreatures)
 	{
 		if (!IsValid(Creature))
@@ -242,28 +810,206 @@ void AEcosystemManager::UpdatePopulationStats()
 			continue;
 		}
 
-		float CreatureFitness = Creature->CalculateFitnessScore();
-		TotalFitness += CreatureFitness;
+		const FVector3f Location(Creature->GetActorLocation());
+		const FSimulationRandomStream& Stream = Creature->GetRandomStream();
+
+		FSnapshotCreatureRecord& Record = Snapshot.Creatures.AddZeroed_GetRef();
+		Record.Genome = FPackedGenome::Pack(Creature->GetGenes());
+		Record.LifeState = Creature->GetLifeState();
+		Record.CreatureId = Creature->GetCreatureId();
+		Record.RandomKey = Stream.GetKey();
+		Record.RandomCounter = Stream.GetCounter();
+		Record.Location[0] = Location.X;
+		Record.Location[1] = Location.Y;
+		Record.Location[2] = Location.Z;
+		Record.LineageId = Creature->GetLineageId();
+		Record.LineageParents[0] = FLineageArena::InvalidId;
+		Record.LineageParents[1] = FLineageArena::InvalidId;
+	}
 
-		if (CreatureFitness > MaxFitness)
+	// Creatures not spawned yet are saved too
+	for (int32 Priority = 0; Priority < (int32)ESpawnPriority::Count; Priority++)
+	{
+		for (int32 i = SpawnQueueHeads[Priority]; i < SpawnQueues[Priority].Num(); i++)
 		{
-			MaxFitness = CreatureFitness;
-			BestGenes = Creature->GetGenes();
+			const FPendingSpawn& Pending = SpawnQueues[Priority][i];
+
+			FSnapshotCreatureRecord& Record = Snapshot.Creatures.AddZeroed_GetRef();
+			Record.Genome = FPackedGenome::Pack(Pending.Genes);
+			Record.LifeState = Pending.LifeState;
+			Record.CreatureId = Pending.CreatureId;
+			Record.RandomKey = Pending.RandomStream.GetKey();
+			Record.RandomCounter = Pending.RandomStream.GetCounter();
+			Record.Location[0] = Pending.Location.X;
+			Record.Location[1] = Pending.Location.Y;
+			Record.Location[2] = Pending.Location.Z;
+			Record.LineageId = Pending.LineageId;
+			Record.LineageParents[0] = Pending.Parents[0];
+			Record.LineageParents[1] = Pending.Parents[1];
 		}
+	}
 
-		// Update distributions
-		FCreatureGenes Genes = Creature->GetGenes();
-		CurrentStats.MovementTypeDistribution.FindOrAdd(Genes.MovementType)++;
-		CurrentStats.AggressionDistribution.FindOrAdd(Genes.AggressionLevel)++;
+	for (const FCreatureRecord& Record : HistoryLog.GetRecent(HistoryCapacity))
+	{
+		Snapshot.History.Add(FCreatureHistoryDiskRecord::FromRecord(Record));
+	}
+
+	for (const FCreatureRecord& Record : TopPerformerHeap)
+	{
+		Snapshot.TopPerformers.Add(FCreatureHistoryDiskRecord::FromRecord(Record));
+	}
+
+	Lineage.CopyTo(Snapshot.Lineage);
+
+	// Only the copy above runs on the game thread
+	const int32 NumCreatures = Snapshot.Creatures.Num();
+	SaveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Snapshot = MoveTemp(Snapshot), Path = GetSnapshotPath()]() mutable
+		{
+			if (!Snapshot.SaveToFile(Path))
+			{
+				UE_LOG(LogTemp, Error, TEXT("Failed to write ecosystem snapshot %s"), *Path);
+			}
+		});
+
+	UE_LOG(LogTemp, Warning, TEXT("Saving %d creatures to %s"), NumCreatures, *GetSnapshotPath());
+	UE_LOG(LogTemp, Warning, TEXT("Generation %d Data - Population: %d, Avg Fitness: %.2f, Max Fitness: %.2f"), 
+		CurrentStats.Generation, CurrentStats.TotalPopulation, CurrentStats.AverageFitness, CurrentStats.MaxFitness);
+
+	if (const UCreaturePoolSubsystem* Pool = GetWorld()->GetSubsystem<UCreaturePoolSubsystem>())
+	{
+		const FCreaturePoolStats PoolStats = Pool->GetPoolStats();
+		UE_LOG(LogTemp, Warning, TEXT("Creature Pool - Hit Rate: %.1f%%, Pooled: %d, Destroys Avoided: %d, Est. Time Saved: %.2f ms, GC: %.2f ms per generation (pooling %s)"),
+			PoolStats.HitRate * 100.0f, PoolStats.PooledCount, PoolStats.DestroysAvoided, PoolStats.EstimatedTimeSavedMs,
+			PoolStats.GarbageCollectionMsPerGeneration, PoolStats.bPoolingEnabled ? TEXT("on") : TEXT("off"));
+	}
+
+	const FGenomeCacheStats CacheStats = GetFitnessCacheStats();
+	UE_LOG(LogTemp, Warning, TEXT("Genome Fitness Cache - Hit Rate: %.1f%%, Hits: %d, Misses: %d, Entries: %d"),
+		CacheStats.HitRate * 100.0f, CacheStats.Hits, CacheStats.Misses, CacheStats.Entries);
+}
+
+void AEcosystemManager::OpenHistoryLog()
+{
+	// Flushes the pending batch to the previous run's file first
+	HistoryLog.Close();
+
+	const FString HistoryPath = FPaths::ProjectSavedDir() / TEXT("EcosystemHistory") / FString::Printf(TEXT("History_%llu_%s.bin"), ActiveSeed, *FDateTime::Now().ToString());
+	HistoryLog.Open(HistoryPath, HistoryCapacity, HistoryFlushBatchSize);
+}
+
+void AEcosystemManager::LoadGenerationData()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	WaitForSave();
+
+	FEcosystemSnapshotReader Reader;
+	if (!Reader.Open(GetSnapshotPath()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("No ecosystem snapshot at %s"), *GetSnapshotPath());
+		return;
+	}
+
+	// Drop the current run, the novelty archive and quantile history are not part of a snapshot
+	WaitForBreeding();
+	ClearSpawnQueue();
+	ReleaseAllCreatures();
+	NoveltyArchives.Reset();
+	Speciations.Reset();
+	GenerationSketch.Reset();
+	QuantileHistory.Reset();
+
+	const FEcosystemSnapshotHeader& Header = Reader.GetHeader();
+	CurrentStats = FPopulationStats();
+	CurrentStats.Generation = Header.Generation;
+	CurrentGenerationTime = Header.GenerationTime;
+	ActiveSeed = Header.Seed;
+	NextCreatureId = Header.NextCreatureId;
+
+	// The resumed run gets its own log, deaths of the abandoned one stay in the old file
+	OpenHistoryLog();
+	HistoryLog.Preload(Reader.GetHistory());
+	Lineage.Load(Reader.GetLineage());
+
+	TopPerformerHeap.Reset();
+	for (const FCreatureHistoryDiskRecord& Record : Reader.GetTopPerformers())
+	{
+		RecordTopPerformer(Record.ToRecord());
+	}
+
+	// Creatures that were alive keep their id, stats and random stream, and spawn first
+	const double QueueTime = FPlatformTime::Seconds();
+	for (const FSnapshotCreatureRecord& Record : Reader.GetCreatures())
+	{
+		FPendingSpawn Pending{ Record.Genome.Unpack(), FVector(Record.Location[0], Record.Location[1], Record.Location[2]), QueueTime };
+		Pending.CreatureId = Record.CreatureId;
+		Pending.LineageId = Record.LineageId;
+		Pending.Parents[0] = Record.LineageParents[0];
+		Pending.Parents[1] = Record.LineageParents[1];
+
+		// Only creatures that spawned have a lineage record
+		if (Record.LineageId != FLineageArena::InvalidId)
+		{
+			Pending.bRestoreState = true;
+			Pending.LifeState = Record.LifeState;
+			Pending.RandomStream = FSimulationRandomStream::FromState(Record.RandomKey, Record.RandomCounter);
+			EnqueueSpawn(MoveTemp(Pending), ESpawnPriority::Elite);
+		}
+		else
+		{
+			EnqueueSpawn(MoveTemp(Pending), ESpawnPriority::Offspring);
+		}
 	}
 
-	CurrentStats.AverageFitness = TotalFitness / CurrentStats.TotalPopulation;
+	UE_LOG(LogTemp, Warning, TEXT("Loaded generation %d with %d creatures from %s in %.1f ms (seed %llu)"),
+		Header.Generation, Reader.GetCreatures().Num(), *GetSnapshotPath(), (FPlatformTime::Seconds() - StartTime) * 1000.0, ActiveSeed);
+}
+
+void AEcosystemManager::UpdatePopulationStats()
+{
+	CurrentStats.TotalPopulation = ActiveCreatures.Num();
+
+	if (CurrentStats.TotalPopulation == 0)
+	{
+		return;
+	}
+
+	// Fitness statistics come from the running aggregates, no creature is visited
+	const double Now = UEcosystemClockSubsystem::GetSimulationSeconds(GetWorld());
+	CurrentStats.AverageFitness = Aggregates.GetTotalFitness(Now) / CurrentStats.TotalPopulation;
+
+	float MaxFitness = 0.0f;
+	ACreature* Leader = Aggregates.FindLeader(Now, MaxFitness);
 	CurrentStats.MaxFitness = MaxFitness;
-	CurrentStats.DominantGenes = BestGenes;
+
+	// Genes are only copied when the leader changes
+	if (Leader != DominantCreature && IsValid(Leader))
+	{
+		DominantCreature = Leader;
+		CurrentStats.DominantGenes = Leader->GetGenes();
+	}
+
+	// Update distributions
+	for (int32 i = 0; i < (int32)EMovementType::Count; i++)
+	{
+		CurrentStats.MovementTypeDistribution[i] = Aggregates.GetMovementTypeCount(static_cast<EMovementType>(i));
+	}
+
+	for (int32 i = 0; i < (int32)EAggressionLevel::Count; i++)
+	{
+		CurrentStats.AggressionDistribution[i] = Aggregates.GetAggressionLevelCount(static_cast<EAggressionLevel>(i));
+	}
 }
 
 void AEcosystemManager::CheckGenerationConditions()
 {
+	// The next generation is already being bred, or has not finished spawning
+	if (bGenerationInProgress || PendingSpawnCount > 0)
+	{
+		return;
+	}
+
 	bool bShouldAdvance = false;
 
 	// Check time limit
@@ -273,17 +1019,18 @@ void AEcosystemManager::CheckGenerationConditions()
 		UE_LOG(LogTemp, Warning, TEXT("Advancing generation due to time limit"));
 	}
 
-	// Check population thresholds
-	if (CurrentStats.TotalPopulation <= MinPopulation)
+	// Check population thresholds, on the live count since the stats only refresh every StatsUpdateInterval
+	const int32 Population = ActiveCreatures.Num();
+	if (Population <= MinPopulation)
 	{
 		bShouldAdvance = true;
-		UE_LOG(LogTemp, Warning, TEXT("Advancing generation due to low population: %d"), CurrentStats.TotalPopulation);
+		UE_LOG(LogTemp, Warning, TEXT("Advancing generation due to low population: %d"), Population);
 	}
 
-	if (CurrentStats.TotalPopulation >= MaxPopulation)
+	if (Population >= MaxPopulation)
 	{
 		bShouldAdvance = true;
-		UE_LOG(LogTemp, Warning, TEXT("Advancing generation due to high population: %d"), CurrentStats.TotalPopulation);
+		UE_LOG(LogTemp, Warning, TEXT("Advancing generation due to high population: %d"), Population);
 	}
 
 	if (bShouldAdvance)
@@ -292,10 +1039,30 @@ void AEcosystemManager::CheckGenerationConditions()
 	}
 }
 
-FVector AEcosystemManager::GetRandomSpawnLocation() const
+int32 AEcosystemManager::GetIslandIndex(const FVector& Location) const
 {
-	float Angle = FMath::RandRange(0.0f, 2.0f * PI);
-	float Distance = FMath::RandRange(100.0f, SpawnRadius);
+	const int32 NumIslands = GetIslandCount();
+	if (NumIslands == 1)
+	{
+		return 0;
+	}
+
+	const FVector Offset = Location - GetActorLocation();
+	float Angle = FMath::Atan2(Offset.Y, Offset.X);
+	if (Angle < 0.0f)
+	{
+		Angle += 2.0f * PI;
+	}
+
+	return FMath::Min(FMath::FloorToInt(Angle / (2.0f * PI) * NumIslands), NumIslands - 1);
+}
+
+FVector AEcosystemManager::GetRandomSpawnLocation(FSimulationRandomStream& Stream, int32 Island) const
+{
+	// Each island owns an equal angular sector of the spawn radius
+	const float SectorAngle = 2.0f * PI / GetIslandCount();
+	float Angle = Stream.FRandRange(Island * SectorAngle, (Island + 1) * SectorAngle);
+	float Distance = Stream.FRandRange(100.0f, SpawnRadius);
 	
 	FVector Offset = FVector(
 		FMath::Cos(Angle) * Distance,
@@ -306,11 +1073,21 @@ FVector AEcosystemManager::GetRandomSpawnLocation() const
 	return GetActorLocation() + Offset;
 }
 
-TArray<FCreatureGenes> AEcosystemManager::SelectParentsForReproduction() const
+void AEcosystemManager::GatherPopulationSnapshot(TArray<FGenePool>& OutIslandGenes, TArray<TArray<float>>& OutIslandFitness, TArray<FFitnessObjectives>& OutIslandObjectives) const
 {
-	TArray<FCreatureRecord> CurrentRecords;
+	const int32 NumIslands = GetIslandCount();
+	OutIslandGenes.SetNum(NumIslands);
+	OutIslandFitness.SetNum(NumIslands);
+	OutIslandObjectives.SetNum(NumIslands);
+
+	for (int32 Island = 0; Island < NumIslands; Island++)
+	{
+		OutIslandGenes[Island].Reset(ActiveCreatures.Num() / NumIslands);
+		OutIslandFitness[Island].Reset(ActiveCreatures.Num() / NumIslands);
+		OutIslandObjectives[Island].Reset(ActiveCreatures.Num() / NumIslands);
+	}
 
-	// Create records for current population
+	// Creatures belong to the island they stand on, wandering into another sector migrates them
 	for (ACreature* Creature : ActiveCreatures)
 	{
 		if (!IsValid(Creature))
@@ -318,32 +1095,11 @@ TArray<FCreatureGenes> AEcosystemManager::SelectParentsForReproduction() const
 			continue;
 		}
 
-		FCreatureRecord Record;
-		Record.Genes = Creature->GetGenes();
-		Record.FitnessScore = Creature->CalculateFitnessScore();
-		Record.LifeTime = Creature->GetAge();
-		Record.Generation = CurrentStats.Generation;
-		Record.OffspringCount = Creature->OffspringCount;
-
-		CurrentRecords.Add(Record);
-	}
-
-	// Sort by fitness
-	CurrentRecords.Sort([](const FCreatureRecord& A, const FCreatureRecord& B)
-	{
-		return A.FitnessScore > B.FitnessScore;
-	});
-
-	// Select top performers
-	int32 ParentCount = FMath::Max(2, FMath::RoundToInt(CurrentRecords.Num() * 0.5f));
-	TArray<FCreatureGenes> ParentGenes;
-
-	for (int32 i = 0; i < FMath::Min(ParentCount, CurrentRecords.Num()); i++)
-	{
-		ParentGenes.Add(CurrentRecords[i].Genes);
+		const int32 Island = GetIslandIndex(Creature->GetActorLocation());
+		OutIslandGenes[Island].Add(Creature->GetGenes(), Creature->GetLineageId());
+		OutIslandFitness[Island].Add(Creature->CalculateFitnessScore());
+		OutIslandObjectives[Island].Add(Creature->GetGenes(), Creature->GetLifeState());
 	}
-
-	return ParentGenes;
 }
 
 void AEcosystemManager::CleanupDeadCreatures()
@@ -352,6 +1108,7 @@ void AEcosystemManager::CleanupDeadCreatures()
 	{
 		if (!IsValid(ActiveCreatures[i]))
 		{
+			Aggregates.Remove(ActiveCreatures[i]);
 			ActiveCreatures.RemoveAt(i);
 		}
 	}
@@ -372,7 +1129,9 @@ void AEcosystemManager::OnCreatureDeath(ACreature* DeadCreature, float FitnessSc
 	Record.Generation = CurrentStats.Generation;
 	Record.OffspringCount = DeadCreature->OffspringCount;
 
-	CreatureHistory.Add(Record);
+	HistoryLog.Add(Record);
+	RecordTopPerformer(Record);
+	GenerationSketch.Add(Record.Genes, FitnessScore);
 
 	// Remove from active list
 	RemoveCreature(DeadCreature);
@@ -380,12 +1139,14 @@ void AEcosystemManager::OnCreatureDeath(ACreature* DeadCreature, float FitnessSc
 
 void AEcosystemManager::OnCreatureReproduction(ACreature* Parent1, ACreature* Parent2, FCreatureGenes OffspringGenes)
 {
-	// Spawn new creature immediately or queue for later
-	if (ActiveCreatures.Num() < MaxPopulation)
+	// Queue the newborn behind any generation still spawning
+	if (ActiveCreatures.Num() + PendingSpawnCount < MaxPopulation)
 	{
+		const int32 CreatureId = NextCreatureId++;
+		FSimulationRandomStream Stream(ActiveSeed, CreatureId, CurrentStats.Generation, ERandomStreamPurpose::Spawn);
 		FVector SpawnLocation = (Parent1->GetActorLocation() + Parent2->GetActorLocation()) * 0.5f;
-		SpawnLocation += FVector(FMath::RandRange(-200.0f, 200.0f), FMath::RandRange(-200.0f, 200.0f), 0.0f);
+		SpawnLocation += FVector(Stream.FRandRange(-200.0f, 200.0f), Stream.FRandRange(-200.0f, 200.0f), 0.0f);
 		
-		SpawnCreature(OffspringGenes, SpawnLocation);
+		QueueSpawnWithId(OffspringGenes, SpawnLocation, ESpawnPriority::Birth, CreatureId, Parent1->GetLineageId(), Parent2->GetLineageId());
 	}
 }
@@ -3,6 +3,7 @@
 #include "NaniteEnvironment.h"
 #include "DynamicWeatherSystem.h"
 #include "Creature.h"
+#include "EcosystemClockSubsystem.h"
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "GameFramework/WorldSettings.h"
@@ -24,6 +25,16 @@ void AEcosystemSandboxGameMode::BeginPlay()
 	SetupChaosPhysics();
 	InitializeEcosystemComponents();
 
+	if (UEcosystemClockSubsystem* Clock = GetWorld()->GetSubsystem<UEcosystemClockSubsystem>())
+	{
+		// -FastForward on the command line turns it on as well
+		if (bFastForward)
+		{
+			Clock->SetFastForward(true);
+		}
+		Clock->SetRunning(false);
+	}
+
 	if (bAutoStartSimulation)
 	{
 		StartSimulation();
@@ -34,13 +45,27 @@ void AEcosystemSandboxGameMode::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Apply time scale if simulation is running
+	// The clock applies the time scale and the world time dilation that goes with it
 	if (bSimulationRunning && GetWorld())
 	{
-		AWorldSettings* WorldSettings = GetWorld()->GetWorldSettings();
-		if (WorldSettings)
+		if (UEcosystemClockSubsystem* Clock = GetWorld()->GetSubsystem<UEcosystemClockSubsystem>())
 		{
-			WorldSettings->SetTimeDilation(SimulationTimeScale);
+			Clock->SetTimeScale(SimulationTimeScale);
+			Clock->SetFixedDeltaTime(FixedTimeStep);
+			Clock->SetStepBudgetMs(StepBudgetMs);
+			Clock->SetMaxSubstepsPerFrame(MaxSubstepsPerFrame);
+			Clock->SetMaxWorldTimeDilation(MaxWorldTimeDilation);
+
+			AchievedTimeScale = Clock->GetAchievedTimeScale();
+
+			// A time scale the clock cannot keep up with is shown, not silently reduced
+			const float NewDroppedSeconds = Clock->GetDroppedSeconds();
+			if (NewDroppedSeconds > DroppedSimulationSeconds && GEngine)
+			{
+				GEngine->AddOnScreenDebugMessage(static_cast<uint64>(GetUniqueID()), 2.0f, FColor::Yellow,
+					FString::Printf(TEXT("Simulation at %.1fx of %.1fx, %.1f simulated seconds dropped"), AchievedTimeScale, SimulationTimeScale, NewDroppedSeconds));
+			}
+			DroppedSimulationSeconds = NewDroppedSeconds;
 		}
 	}
 }
@@ -53,6 +78,11 @@ void AEcosystemSandboxGameMode::StartSimulation()
 	}
 
 	bSimulationRunning = true;
+
+	if (UEcosystemClockSubsystem* Clock = GetWorld()->GetSubsystem<UEcosystemClockSubsystem>())
+	{
+		Clock->SetRunning(true);
+	}
 	
 	if (EcosystemManager)
 	{
@@ -71,13 +101,12 @@ void AEcosystemSandboxGameMode::StopSimulation()
 {
 	bSimulationRunning = false;
 
-	// Reset time scale
+	// Stopping the clock also resets the world time dilation
 	if (GetWorld())
 	{
-		AWorldSettings* WorldSettings = GetWorld()->GetWorldSettings();
-		if (WorldSettings)
+		if (UEcosystemClockSubsystem* Clock = GetWorld()->GetSubsystem<UEcosystemClockSubsystem>())
 		{
-			WorldSettings->SetTimeDilation(1.0f);
+			Clock->SetRunning(false);
 		}
 	}
 
@@ -0,0 +1,151 @@
+#include "EcosystemSnapshot.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	template <typename RecordType>
+	bool WriteSection(IFileHandle& FileHandle, uint64 Offset, const TArray<RecordType>& Records)
+	{
+		// Zero padding up to the aligned section start
+		static const uint8 Zeros[FEcosystemSnapshot::SectionAlignment] = {};
+		const int64 Padding = static_cast<int64>(Offset) - FileHandle.Tell();
+		check(Padding >= 0 && Padding < static_cast<int64>(FEcosystemSnapshot::SectionAlignment));
+
+		return FileHandle.Write(Zeros, Padding)
+			&& FileHandle.Write(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(RecordType));
+	}
+
+	template <typename RecordType>
+	bool SectionFits(uint64 Offset, uint32 Num, uint64 FileSize)
+	{
+		return Offset % FEcosystemSnapshot::SectionAlignment == 0 && Offset + static_cast<uint64>(Num) * sizeof(RecordType) <= FileSize;
+	}
+}
+
+bool FEcosystemSnapshot::SaveToFile(const FString& Path)
+{
+	Header.CreatureRecordSize = sizeof(FSnapshotCreatureRecord);
+	Header.HistoryRecordSize = sizeof(FCreatureHistoryDiskRecord);
+	Header.NumCreatures = Creatures.Num();
+	Header.NumHistory = History.Num();
+	Header.NumTopPerformers = TopPerformers.Num();
+	Header.NumLineage = Lineage.Num();
+	Header.CreaturesOffset = Align(sizeof(FEcosystemSnapshotHeader), SectionAlignment);
+	Header.HistoryOffset = Align(Header.CreaturesOffset + Creatures.Num() * sizeof(FSnapshotCreatureRecord), SectionAlignment);
+	Header.TopPerformersOffset = Align(Header.HistoryOffset + History.Num() * sizeof(FCreatureHistoryDiskRecord), SectionAlignment);
+	Header.LineageOffset = Align(Header.TopPerformersOffset + TopPerformers.Num() * sizeof(FCreatureHistoryDiskRecord), SectionAlignment);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+
+	// A crash mid-write never leaves a truncated snapshot behind
+	const FString TempPath = Path + TEXT(".tmp");
+	{
+		TUniquePtr<IFileHandle> FileHandle(PlatformFile.OpenWrite(*TempPath));
+		if (!FileHandle)
+		{
+			return false;
+		}
+
+		const bool bWritten = FileHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header))
+			&& WriteSection(*FileHandle, Header.CreaturesOffset, Creatures)
+			&& WriteSection(*FileHandle, Header.HistoryOffset, History)
+			&& WriteSection(*FileHandle, Header.TopPerformersOffset, TopPerformers)
+			&& WriteSection(*FileHandle, Header.LineageOffset, Lineage)
+			&& FileHandle->Flush();
+
+		if (!bWritten)
+		{
+			FileHandle.Reset();
+			PlatformFile.DeleteFile(*TempPath);
+			return false;
+		}
+	}
+
+	PlatformFile.DeleteFile(*Path);
+	return PlatformFile.MoveFile(*Path, *TempPath);
+}
+
+FEcosystemSnapshotReader::~FEcosystemSnapshotReader()
+{
+	Close();
+}
+
+bool FEcosystemSnapshotReader::Open(const FString& Path)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const int64 FileSize = PlatformFile.FileSize(*Path);
+	if (FileSize < static_cast<int64>(sizeof(FEcosystemSnapshotHeader)))
+	{
+		return false;
+	}
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*Path));
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, FileSize));
+	}
+
+	if (!MappedRegion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to map ecosystem snapshot %s"), *Path);
+		Close();
+		return false;
+	}
+
+	Data = MappedRegion->GetMappedPtr();
+	Header = reinterpret_cast<const FEcosystemSnapshotHeader*>(Data);
+
+	const uint64 MappedSize = MappedRegion->GetMappedSize();
+	const bool bValid = Header->Magic == FEcosystemSnapshotHeader::ExpectedMagic
+		&& Header->Version == FEcosystemSnapshotHeader::CurrentVersion
+		&& Header->HeaderSize == sizeof(FEcosystemSnapshotHeader)
+		&& Header->CreatureRecordSize == sizeof(FSnapshotCreatureRecord)
+		&& Header->HistoryRecordSize == sizeof(FCreatureHistoryDiskRecord)
+		&& SectionFits<FSnapshotCreatureRecord>(Header->CreaturesOffset, Header->NumCreatures, MappedSize)
+		&& SectionFits<FCreatureHistoryDiskRecord>(Header->HistoryOffset, Header->NumHistory, MappedSize)
+		&& SectionFits<FCreatureHistoryDiskRecord>(Header->TopPerformersOffset, Header->NumTopPerformers, MappedSize)
+		&& SectionFits<FLineageRecord>(Header->LineageOffset, Header->NumLineage, MappedSize);
+
+	if (!bValid)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a compatible ecosystem snapshot"), *Path);
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FEcosystemSnapshotReader::Close()
+{
+	Header = nullptr;
+	Data = nullptr;
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TConstArrayView<FSnapshotCreatureRecord> FEcosystemSnapshotReader::GetCreatures() const
+{
+	return GetSection<FSnapshotCreatureRecord>(Header->CreaturesOffset, Header->NumCreatures);
+}
+
+TConstArrayView<FCreatureHistoryDiskRecord> FEcosystemSnapshotReader::GetHistory() const
+{
+	return GetSection<FCreatureHistoryDiskRecord>(Header->HistoryOffset, Header->NumHistory);
+}
+
+TConstArrayView<FCreatureHistoryDiskRecord> FEcosystemSnapshotReader::GetTopPerformers() const
+{
+	return GetSection<FCreatureHistoryDiskRecord>(Header->TopPerformersOffset, Header->NumTopPerformers);
+}
+
+TConstArrayView<FLineageRecord> FEcosystemSnapshotReader::GetLineage() const
+{
+	return GetSection<FLineageRecord>(Header->LineageOffset, Header->NumLineage);
+}
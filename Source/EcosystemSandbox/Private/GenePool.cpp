@@ -0,0 +1,325 @@
+#include "GenePool.h"
+#include "Math/UnrealMathUtility.h"
+
+namespace
+{
+	void MakeStreamKeys(const FRandomStreamBatch& Streams, int32 Count, TArray<uint64>& OutKeys)
+	{
+		OutKeys.SetNumUninitialized(Count, EAllowShrinking::No);
+		for (int32 i = 0; i < Count; i++)
+		{
+			OutKeys[i] = Streams.GetKey(i);
+		}
+	}
+
+	FORCEINLINE float Fraction(uint64 Key, uint32 DrawIndex)
+	{
+		return FSimulationRandomStream::ToFraction(FSimulationRandomStream::Hash(Key, DrawIndex));
+	}
+
+	// Uniform over the values before EnumType::Count
+	template <typename EnumType>
+	FORCEINLINE uint8 RandomEnum(uint64 Key, uint32 DrawIndex)
+	{
+		constexpr uint64 NumValues = static_cast<uint64>(EnumType::Count);
+		return static_cast<uint8>((static_cast<uint64>(FSimulationRandomStream::Hash(Key, DrawIndex)) * NumValues) >> 32);
+	}
+
+	FORCEINLINE FLinearColor RandomColor(uint64 Key, uint32 DrawIndex)
+	{
+		return FLinearColor::MakeFromHSV8(static_cast<uint8>(Fraction(Key, DrawIndex) * 255.0f), 255, 255);
+	}
+
+	// Uses draws DrawIndex and DrawIndex + 1
+	FORCEINLINE float Gaussian(uint64 Key, uint32 DrawIndex)
+	{
+		return FSimulationRandomStream::ToGaussian(FSimulationRandomStream::Hash(Key, DrawIndex), FSimulationRandomStream::Hash(Key, DrawIndex + 1));
+	}
+
+	// Enums and colors are rerolled wholesale, using 8 draws from FirstDraw
+	void MutateDiscrete(FGenePool& Pool, float MutationRate, const uint64* RESTRICT Key, uint32 FirstDraw, int32 StartIndex, int32 Count)
+	{
+		for (int32 i = 0; i < Count; i++)
+		{
+			const int32 Row = StartIndex + i;
+
+			if (Fraction(Key[i], FirstDraw) < MutationRate)
+			{
+				Pool.MovementTypes[Row] = RandomEnum<EMovementType>(Key[i], FirstDraw + 1);
+			}
+			if (Fraction(Key[i], FirstDraw + 2) < MutationRate)
+			{
+				Pool.AggressionLevels[Row] = RandomEnum<EAggressionLevel>(Key[i], FirstDraw + 3);
+			}
+			if (Fraction(Key[i], FirstDraw + 4) < MutationRate)
+			{
+				Pool.PrimaryColors[Row] = RandomColor(Key[i], FirstDraw + 5);
+			}
+			if (Fraction(Key[i], FirstDraw + 6) < MutationRate)
+			{
+				Pool.SecondaryColors[Row] = RandomColor(Key[i], FirstDraw + 7);
+			}
+		}
+	}
+}
+
+void FGenePool::Reset(int32 ExpectedNum)
+{
+	for (TArray<float>& Column : Traits)
+	{
+		Column.Reset(ExpectedNum);
+	}
+	MovementTypes.Reset(ExpectedNum);
+	AggressionLevels.Reset(ExpectedNum);
+	PrimaryColors.Reset(ExpectedNum);
+	SecondaryColors.Reset(ExpectedNum);
+	StepSizes.Reset(ExpectedNum);
+	for (TArray<uint32>& Column : Lineages)
+	{
+		Column.Reset(ExpectedNum);
+	}
+}
+
+void FGenePool::SetNumUninitialized(int32 NewNum)
+{
+	for (TArray<float>& Column : Traits)
+	{
+		Column.SetNumUninitialized(NewNum, EAllowShrinking::No);
+	}
+	MovementTypes.SetNumUninitialized(NewNum, EAllowShrinking::No);
+	AggressionLevels.SetNumUninitialized(NewNum, EAllowShrinking::No);
+	PrimaryColors.SetNumUninitialized(NewNum, EAllowShrinking::No);
+	SecondaryColors.SetNumUninitialized(NewNum, EAllowShrinking::No);
+	StepSizes.SetNumUninitialized(NewNum, EAllowShrinking::No);
+	for (TArray<uint32>& Column : Lineages)
+	{
+		Column.SetNumUninitialized(NewNum, EAllowShrinking::No);
+	}
+}
+
+int32 FGenePool::Add(const FCreatureGenes& Genes, uint32 LineageId)
+{
+	const int32 Index = Num();
+	SetNumUninitialized(Index + 1);
+	Set(Index, Genes);
+	Lineages[0][Index] = LineageId;
+	Lineages[1][Index] = LineageId;
+	return Index;
+}
+
+void FGenePool::Set(int32 Index, const FCreatureGenes& Genes)
+{
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		Traits[TraitIndex][Index] = Genes.*FGeneTraits::Table[TraitIndex].Member;
+	});
+	MovementTypes[Index] = static_cast<uint8>(Genes.MovementType);
+	AggressionLevels[Index] = static_cast<uint8>(Genes.AggressionLevel);
+	PrimaryColors[Index] = Genes.PrimaryColor;
+	SecondaryColors[Index] = Genes.SecondaryColor;
+	StepSizes[Index] = Genes.MutationStepSize;
+}
+
+FCreatureGenes FGenePool::Get(int32 Index) const
+{
+	FCreatureGenes Genes;
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		Genes.*FGeneTraits::Table[TraitIndex].Member = Traits[TraitIndex][Index];
+	});
+	Genes.MovementType = static_cast<EMovementType>(MovementTypes[Index]);
+	Genes.AggressionLevel = static_cast<EAggressionLevel>(AggressionLevels[Index]);
+	Genes.PrimaryColor = PrimaryColors[Index];
+	Genes.SecondaryColor = SecondaryColors[Index];
+	Genes.MutationStepSize = StepSizes[Index];
+	return Genes;
+}
+
+void FGenePool::CopyRow(const FGenePool& Source, int32 SourceIndex, int32 DestIndex)
+{
+	for (int32 Trait = 0; Trait < NumTraits; Trait++)
+	{
+		Traits[Trait][DestIndex] = Source.Traits[Trait][SourceIndex];
+	}
+	MovementTypes[DestIndex] = Source.MovementTypes[SourceIndex];
+	AggressionLevels[DestIndex] = Source.AggressionLevels[SourceIndex];
+	PrimaryColors[DestIndex] = Source.PrimaryColors[SourceIndex];
+	SecondaryColors[DestIndex] = Source.SecondaryColors[SourceIndex];
+	StepSizes[DestIndex] = Source.StepSizes[SourceIndex];
+	Lineages[0][DestIndex] = Source.Lineages[0][SourceIndex];
+	Lineages[1][DestIndex] = Source.Lineages[1][SourceIndex];
+}
+
+void FGenePool::GenerateRandomBatch(int32 Count, const FRandomStreamBatch& Streams)
+{
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	const int32 Start = Num();
+	SetNumUninitialized(Start + Count);
+
+	TArray<uint64> Keys;
+	MakeStreamKeys(Streams, Count, Keys);
+	const uint64* RESTRICT Key = Keys.GetData();
+
+	// Continuous traits: uniform over the trait range, one draw per trait
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[TraitIndex];
+		float* RESTRICT Column = Traits[TraitIndex].GetData() + Start;
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			Column[i] = Descriptor.Min + Fraction(Key[i], TraitIndex) * Descriptor.GetRange();
+		}
+	});
+
+	// Enums and colors
+	for (int32 i = 0; i < Count; i++)
+	{
+		const int32 Row = Start + i;
+		MovementTypes[Row] = RandomEnum<EMovementType>(Key[i], NumTraits);
+		AggressionLevels[Row] = RandomEnum<EAggressionLevel>(Key[i], NumTraits + 1);
+		PrimaryColors[Row] = RandomColor(Key[i], NumTraits + 2);
+		SecondaryColors[Row] = RandomColor(Key[i], NumTraits + 3);
+		StepSizes[Row] = FCreatureGenes::DefaultStepSize;
+		Lineages[0][Row] = FLineageArena::InvalidId;
+		Lineages[1][Row] = FLineageArena::InvalidId;
+	}
+}
+
+void FGenePool::MutateAll(float MutationRate, float MutationStrength, const FRandomStreamBatch& Streams, int32 StartIndex)
+{
+	MutateRange(MutationRate, MutationStrength, Streams, StartIndex, Num() - StartIndex);
+}
+
+void FGenePool::MutateRange(float MutationRate, float MutationStrength, const FRandomStreamBatch& Streams, int32 StartIndex, int32 Count)
+{
+	check(StartIndex + Count <= Num());
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	TArray<uint64> Keys;
+	MakeStreamKeys(Streams, Count, Keys);
+	const uint64* RESTRICT Key = Keys.GetData();
+
+	// Continuous traits: branch-free select so the loop vectorizes
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[TraitIndex];
+		constexpr uint32 RollDraw = TraitIndex * 2;
+		constexpr uint32 DeltaDraw = TraitIndex * 2 + 1;
+		const float Strength = MutationStrength * Descriptor.MutationScale;
+		float* RESTRICT Column = Traits[TraitIndex].GetData() + StartIndex;
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float Change = (Fraction(Key[i], DeltaDraw) * 2.0f - 1.0f) * Strength;
+			const float Mutated = FMath::Clamp(Column[i] + Change, Descriptor.Min, Descriptor.Max);
+			Column[i] = Fraction(Key[i], RollDraw) < MutationRate ? Mutated : Column[i];
+		}
+	});
+
+	MutateDiscrete(*this, MutationRate, Key, NumTraits * 2, StartIndex, Count);
+}
+
+void FGenePool::MutateRangeSelfAdaptive(float MutationRate, const FRandomStreamBatch& Streams, int32 StartIndex, int32 Count)
+{
+	check(StartIndex + Count <= Num());
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	TArray<uint64> Keys;
+	MakeStreamKeys(Streams, Count, Keys);
+	const uint64* RESTRICT Key = Keys.GetData();
+
+	// Log-normal step size update first, draws 0 and 1
+	const float LearningRate = FCreatureGenes::GetStepSizeLearningRate();
+	float* RESTRICT StepSize = StepSizes.GetData() + StartIndex;
+	for (int32 i = 0; i < Count; i++)
+	{
+		StepSize[i] = FMath::Clamp(StepSize[i] * FMath::Exp(LearningRate * Gaussian(Key[i], 0)), FCreatureGenes::MinStepSize, FCreatureGenes::MaxStepSize);
+	}
+
+	// Every trait takes a Gaussian step scaled by its range, one column at a time
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[TraitIndex];
+		constexpr uint32 Draw = 2 + TraitIndex * 2;
+		float* RESTRICT Column = Traits[TraitIndex].GetData() + StartIndex;
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			Column[i] = Descriptor.Reflect(Column[i] + StepSize[i] * Descriptor.GetRange() * Gaussian(Key[i], Draw));
+		}
+	});
+
+	MutateDiscrete(*this, MutationRate, Key, 2 + NumTraits * 2, StartIndex, Count);
+}
+
+void FGenePool::CrossoverBatch(const FGenePool& Parents, TConstArrayView<int32> Parent1Indices, TConstArrayView<int32> Parent2Indices, const FRandomStreamBatch& Streams)
+{
+	const int32 Start = Num();
+	SetNumUninitialized(Start + Parent1Indices.Num());
+	CrossoverInto(Parents, Parent1Indices, Parent2Indices, Streams, Start);
+}
+
+void FGenePool::CrossoverInto(const FGenePool& Parents, TConstArrayView<int32> Parent1Indices, TConstArrayView<int32> Parent2Indices, const FRandomStreamBatch& Streams, int32 DestIndex)
+{
+	check(Parent1Indices.Num() == Parent2Indices.Num());
+	check(&Parents != this);
+
+	const int32 Count = Parent1Indices.Num();
+	check(DestIndex + Count <= Num());
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	const int32 Start = DestIndex;
+
+	TArray<uint64> Keys;
+	MakeStreamKeys(Streams, Count, Keys);
+	const uint64* RESTRICT Key = Keys.GetData();
+	const int32* RESTRICT Index1 = Parent1Indices.GetData();
+	const int32* RESTRICT Index2 = Parent2Indices.GetData();
+
+	// Uniform crossover: each trait column picks parent 1 or parent 2 independently
+	for (int32 Trait = 0; Trait < NumTraits; Trait++)
+	{
+		const float* RESTRICT Source = Parents.Traits[Trait].GetData();
+		float* RESTRICT Column = Traits[Trait].GetData() + Start;
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			Column[i] = Fraction(Key[i], Trait) < 0.5f ? Source[Index1[i]] : Source[Index2[i]];
+		}
+	}
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		const int32 Row = Start + i;
+		MovementTypes[Row] = Parents.MovementTypes[Fraction(Key[i], NumTraits) < 0.5f ? Index1[i] : Index2[i]];
+		AggressionLevels[Row] = Parents.AggressionLevels[Fraction(Key[i], NumTraits + 1) < 0.5f ? Index1[i] : Index2[i]];
+		PrimaryColors[Row] = Parents.PrimaryColors[Fraction(Key[i], NumTraits + 2) < 0.5f ? Index1[i] : Index2[i]];
+		SecondaryColors[Row] = Parents.SecondaryColors[Fraction(Key[i], NumTraits + 3) < 0.5f ? Index1[i] : Index2[i]];
+
+		// Step sizes are averaged on a log scale
+		StepSizes[Row] = FMath::Sqrt(Parents.StepSizes[Index1[i]] * Parents.StepSizes[Index2[i]]);
+
+		// Parent rows are creatures, whose id is in both lineage columns
+		Lineages[0][Row] = Parents.Lineages[0][Index1[i]];
+		Lineages[1][Row] = Parents.Lineages[0][Index2[i]];
+	}
+}
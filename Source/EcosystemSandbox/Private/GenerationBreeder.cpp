@@ -0,0 +1,125 @@
+#include "GenerationBreeder.h"
+#include "Async/ParallelFor.h"
+
+int32 FGenerationBreeder::GetTruncationCount(int32 PopulationNum)
+{
+	return FMath::Min(PopulationNum, FMath::Max(2, FMath::RoundToInt(PopulationNum * 0.5f)));
+}
+
+int32 FGenerationBreeder::GetEliteCount(int32 PopulationNum, const FBreedingParams& Params)
+{
+	const int32 TruncationCount = GetTruncationCount(PopulationNum);
+	return FMath::Min(FMath::RoundToInt(TruncationCount * Params.ElitePercentage), Params.PopulationSize);
+}
+
+void FGenerationBreeder::SelectParents(TConstArrayView<float> Fitness, const FBreedingParams& Params, TArray<int32>& OutEliteRows, TArray<int32>& OutMatingPool)
+{
+	const int32 TruncationCount = GetTruncationCount(Fitness.Num());
+	const int32 EliteCount = GetEliteCount(Fitness.Num(), Params);
+
+	OutEliteRows = FGeneticSelection::SelectTopK(Fitness, EliteCount);
+
+	// Truncation keeps the top share, sampling strategies draw a full-size pool
+	const int32 PoolSize = Params.SelectionStrategy == ESelectionStrategy::Truncation ? TruncationCount : Fitness.Num();
+	const FRandomStreamBatch PoolStreams(Params.Seed, Params.Generation, 0, ERandomStreamPurpose::MatingPool);
+	FGeneticSelection::BuildMatingPool(Params.SelectionStrategy, Fitness, PoolSize, Params.TournamentSize, PoolStreams, OutMatingPool);
+}
+
+void FGenerationBreeder::Breed(const FGenePool& Population, TConstArrayView<float> Fitness, const FBreedingParams& Params, FGenePool& OutNextGeneration)
+{
+	check(Population.Num() == Fitness.Num());
+
+	TArray<int32> EliteRows;
+	TArray<int32> MatingPool;
+	SelectParents(Fitness, Params, EliteRows, MatingPool);
+
+	FGenePool ParentPool;
+	ParentPool.SetNumUninitialized(MatingPool.Num());
+	for (int32 i = 0; i < MatingPool.Num(); i++)
+	{
+		ParentPool.CopyRow(Population, MatingPool[i], i);
+	}
+
+	const int32 ParentCount = ParentPool.Num();
+	const int32 EliteCount = EliteRows.Num();
+	const int32 OffspringCount = FMath::Max(0, Params.PopulationSize - EliteCount);
+
+	OutNextGeneration.Reset(EliteCount + OffspringCount);
+
+	// Keep elite unchanged
+	OutNextGeneration.SetNumUninitialized(EliteCount);
+	for (int32 i = 0; i < EliteCount; i++)
+	{
+		OutNextGeneration.CopyRow(Population, EliteRows[i], i);
+	}
+
+	// Offspring slot i draws from stream EliteCount + i of this generation
+	const FRandomStreamBatch OffspringStreams(Params.Seed, Params.Generation, EliteCount, ERandomStreamPurpose::Selection);
+
+	// Start over if nobody survived
+	if (ParentCount == 0)
+	{
+		OutNextGeneration.GenerateRandomBatch(OffspringCount, OffspringStreams.WithPurpose(ERandomStreamPurpose::Genesis));
+		return;
+	}
+
+	OutNextGeneration.SetNumUninitialized(EliteCount + OffspringCount);
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(OffspringCount, ChunkSize);
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		const int32 ChunkStart = ChunkIndex * ChunkSize;
+		const int32 ChunkCount = FMath::Min(ChunkSize, OffspringCount - ChunkStart);
+		const FRandomStreamBatch ChunkStreams = OffspringStreams.Offset(ChunkStart);
+
+		// Pick two different random parents per offspring
+		TArray<int32, TInlineAllocator<ChunkSize>> Parent1Indices;
+		TArray<int32, TInlineAllocator<ChunkSize>> Parent2Indices;
+		Parent1Indices.SetNumUninitialized(ChunkCount);
+		Parent2Indices.SetNumUninitialized(ChunkCount);
+
+		for (int32 i = 0; i < ChunkCount; i++)
+		{
+			FSimulationRandomStream Stream = ChunkStreams.GetStream(i);
+			int32 Parent1Index = Stream.RandRange(0, ParentCount - 1);
+			int32 Parent2Index = Stream.RandRange(0, ParentCount - 1);
+
+			while (Parent2Index == Parent1Index && ParentCount > 1)
+			{
+				Parent2Index = Stream.RandRange(0, ParentCount - 1);
+			}
+
+			Parent1Indices[i] = Parent1Index;
+			Parent2Indices[i] = Parent2Index;
+		}
+
+		// Create offspring from crossover and mutation
+		const int32 DestIndex = EliteCount + ChunkStart;
+		OutNextGeneration.CrossoverInto(ParentPool, Parent1Indices, Parent2Indices, ChunkStreams.WithPurpose(ERandomStreamPurpose::Crossover), DestIndex);
+		const FRandomStreamBatch MutationStreams = ChunkStreams.WithPurpose(ERandomStreamPurpose::Mutation);
+		if (Params.MutationMode == EMutationMode::SelfAdaptive)
+		{
+			OutNextGeneration.MutateRangeSelfAdaptive(Params.MutationRate, MutationStreams, DestIndex, ChunkCount);
+		}
+		else
+		{
+			OutNextGeneration.MutateRange(Params.MutationRate, Params.MutationStrength, MutationStreams, DestIndex, ChunkCount);
+		}
+	});
+}
+
+void FGenerationBreeder::Breed(const FGenePool& Population, TConstArrayView<float> Fitness, const FFitnessObjectives& Objectives, const FBreedingParams& Params, FGenePool& OutNextGeneration)
+{
+	if (Params.SelectionStrategy != ESelectionStrategy::NSGA2)
+	{
+		Breed(Population, Fitness, Params, OutNextGeneration);
+		return;
+	}
+
+	check(Population.Num() == Objectives.Num());
+
+	// Elites by score fill the next generation front by front, the least crowded rows of the last front first
+	TArray<float> Scores;
+	FMultiObjectiveSelection::ComputeSelectionScores(Objectives, Scores);
+	Breed(Population, Scores, Params, OutNextGeneration);
+}
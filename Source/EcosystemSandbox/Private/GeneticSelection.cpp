@@ -0,0 +1,203 @@
+#include "GeneticSelection.h"
+
+namespace
+{
+	// Higher fitness first, ties broken by row so every strategy is deterministic
+	FORCEINLINE bool IsFitter(TConstArrayView<float> Fitness, int32 A, int32 B)
+	{
+		return Fitness[A] != Fitness[B] ? Fitness[A] > Fitness[B] : A < B;
+	}
+}
+
+void FGeneticSelection::PartitionTopK(TArrayView<int32> Indices, TConstArrayView<float> Fitness, int32 K)
+{
+	if (K <= 0 || K >= Indices.Num())
+	{
+		return;
+	}
+
+	// Quickselect for position K - 1 with a median-of-three pivot
+	int32 Left = 0;
+	int32 Right = Indices.Num() - 1;
+	const int32 Target = K - 1;
+
+	while (Left < Right)
+	{
+		const int32 Mid = Left + (Right - Left) / 2;
+		if (IsFitter(Fitness, Indices[Mid], Indices[Left]))
+		{
+			Swap(Indices[Mid], Indices[Left]);
+		}
+		if (IsFitter(Fitness, Indices[Right], Indices[Left]))
+		{
+			Swap(Indices[Right], Indices[Left]);
+		}
+		if (IsFitter(Fitness, Indices[Right], Indices[Mid]))
+		{
+			Swap(Indices[Right], Indices[Mid]);
+		}
+
+		const int32 Pivot = Indices[Mid];
+		int32 i = Left;
+		int32 j = Right;
+
+		while (i <= j)
+		{
+			while (IsFitter(Fitness, Indices[i], Pivot))
+			{
+				i++;
+			}
+			while (IsFitter(Fitness, Pivot, Indices[j]))
+			{
+				j--;
+			}
+			if (i <= j)
+			{
+				Swap(Indices[i], Indices[j]);
+				i++;
+				j--;
+			}
+		}
+
+		if (Target <= j)
+		{
+			Right = j;
+		}
+		else if (Target >= i)
+		{
+			Left = i;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+TArray<int32> FGeneticSelection::SelectTopK(TConstArrayView<float> Fitness, int32 K)
+{
+	TArray<int32> Indices;
+	Indices.SetNumUninitialized(Fitness.Num());
+	for (int32 i = 0; i < Fitness.Num(); i++)
+	{
+		Indices[i] = i;
+	}
+
+	K = FMath::Clamp(K, 0, Indices.Num());
+	PartitionTopK(Indices, Fitness, K);
+	Indices.SetNum(K);
+
+	// Only the survivors are sorted
+	Indices.Sort([&Fitness](int32 A, int32 B)
+	{
+		return IsFitter(Fitness, A, B);
+	});
+
+	return Indices;
+}
+
+void FGeneticSelection::BuildMatingPool(ESelectionStrategy Strategy, TConstArrayView<float> Fitness, int32 Count, int32 TournamentSize, const FRandomStreamBatch& Streams, TArray<int32>& OutMatingPool)
+{
+	OutMatingPool.Reset(Count);
+
+	if (Fitness.Num() == 0 || Count <= 0)
+	{
+		return;
+	}
+
+	switch (Strategy)
+	{
+		case ESelectionStrategy::Tournament:
+			Tournament(Fitness, Count, TournamentSize, Streams, OutMatingPool);
+			break;
+
+		case ESelectionStrategy::NSGA2:
+			// Fitness holds crowded-comparison scores, NSGA-II always uses binary tournaments
+			Tournament(Fitness, Count, 2, Streams, OutMatingPool);
+			break;
+
+		case ESelectionStrategy::StochasticUniversal:
+		{
+			FSimulationRandomStream Stream = Streams.GetStream(0);
+			StochasticUniversalSampling(Fitness, Count, Stream, OutMatingPool);
+			break;
+		}
+
+		default:
+		{
+			// Truncation: the fittest Count rows reproduce
+			OutMatingPool.SetNumUninitialized(Fitness.Num());
+			for (int32 i = 0; i < Fitness.Num(); i++)
+			{
+				OutMatingPool[i] = i;
+			}
+			PartitionTopK(OutMatingPool, Fitness, Count);
+			OutMatingPool.SetNum(FMath::Min(Count, Fitness.Num()));
+			break;
+		}
+	}
+}
+
+void FGeneticSelection::Tournament(TConstArrayView<float> Fitness, int32 Count, int32 TournamentSize, const FRandomStreamBatch& Streams, TArray<int32>& OutMatingPool)
+{
+	const int32 NumRows = Fitness.Num();
+	TournamentSize = FMath::Max(1, TournamentSize);
+
+	OutMatingPool.SetNumUninitialized(Count);
+	for (int32 Entry = 0; Entry < Count; Entry++)
+	{
+		FSimulationRandomStream Stream = Streams.GetStream(Entry);
+
+		int32 Winner = Stream.RandRange(0, NumRows - 1);
+		for (int32 Round = 1; Round < TournamentSize; Round++)
+		{
+			const int32 Challenger = Stream.RandRange(0, NumRows - 1);
+			if (IsFitter(Fitness, Challenger, Winner))
+			{
+				Winner = Challenger;
+			}
+		}
+
+		OutMatingPool[Entry] = Winner;
+	}
+}
+
+void FGeneticSelection::StochasticUniversalSampling(TConstArrayView<float> Fitness, int32 Count, FSimulationRandomStream& Stream, TArray<int32>& OutMatingPool)
+{
+	const int32 NumRows = Fitness.Num();
+
+	double TotalFitness = 0.0;
+	for (int32 i = 0; i < NumRows; i++)
+	{
+		TotalFitness += FMath::Max(0.0f, Fitness[i]);
+	}
+
+	OutMatingPool.SetNumUninitialized(Count);
+
+	// Nobody has any fitness yet, sample uniformly
+	if (TotalFitness <= 0.0)
+	{
+		for (int32 Entry = 0; Entry < Count; Entry++)
+		{
+			OutMatingPool[Entry] = static_cast<int32>((static_cast<int64>(Entry) * NumRows) / Count);
+		}
+		return;
+	}
+
+	const double Spacing = TotalFitness / Count;
+	double Pointer = Stream.GetFraction() * Spacing;
+	double Cumulative = FMath::Max(0.0f, Fitness[0]);
+	int32 Row = 0;
+
+	for (int32 Entry = 0; Entry < Count; Entry++)
+	{
+		while (Cumulative <= Pointer && Row < NumRows - 1)
+		{
+			Row++;
+			Cumulative += FMath::Max(0.0f, Fitness[Row]);
+		}
+
+		OutMatingPool[Entry] = Row;
+		Pointer += Spacing;
+	}
+}
@@ -0,0 +1,60 @@
+#include "GenomeFitnessCache.h"
+#include "PackedGenome.h"
+
+uint64 FGenomeHash::Hash(const FCreatureGenes& Genes)
+{
+	uint64 Hash = (static_cast<uint64>(Genes.MovementType) << 8) | static_cast<uint64>(Genes.AggressionLevel);
+
+	// Same quantization as FPackedGenome
+	for (int32 Trait = 0; Trait < FGeneTraits::Num; Trait++)
+	{
+		const EGeneTrait GeneTrait = static_cast<EGeneTrait>(Trait);
+		const uint64 Quantized = FPackedGenome::QuantizeTrait(GeneTrait, FGeneTraits::GetValue(Genes, GeneTrait));
+
+		Hash = FSimulationRandomStream::Mix(Hash ^ (Quantized + 0x9E3779B97F4A7C15ull * (Trait + 1)));
+	}
+
+	return Hash;
+}
+
+FGenomeFitnessCache::FGenomeFitnessCache(int32 Capacity)
+	: Entries(FMath::Max(1, Capacity))
+{
+}
+
+void FGenomeFitnessCache::SetCapacity(int32 Capacity)
+{
+	Entries.Empty(FMath::Max(1, Capacity));
+}
+
+FGenomeEvaluation FGenomeFitnessCache::Evaluate(const FCreatureGenes& Genes)
+{
+	const uint64 Key = FGenomeHash::Hash(Genes);
+
+	if (const FGenomeEvaluation* Cached = Entries.FindAndTouch(Key))
+	{
+		Hits++;
+		return *Cached;
+	}
+
+	Misses++;
+	const FGenomeEvaluation Evaluation = FGenomeEvaluation::Evaluate(Genes);
+	Entries.Add(Key, Evaluation);
+	return Evaluation;
+}
+
+FGenomeCacheStats FGenomeFitnessCache::GetStats() const
+{
+	FGenomeCacheStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Entries = Entries.Num();
+	Stats.HitRate = Hits + Misses > 0 ? static_cast<float>(Hits) / (Hits + Misses) : 0.0f;
+	return Stats;
+}
+
+void FGenomeFitnessCache::ResetStats()
+{
+	Hits = 0;
+	Misses = 0;
+}
@@ -0,0 +1,227 @@
+#include "HeadlessEvolution.h"
+
+FHeadlessEvolution::FHeadlessEvolution(const FHeadlessEvolutionParams& InParams)
+	: Params(InParams)
+	, NoveltyArchive(InParams.Novelty)
+	, Speciation(InParams.Speciation)
+{
+}
+
+void FHeadlessEvolution::InitializeRandom()
+{
+	// Same streams as AEcosystemManager::InitializeEcosystem
+	Generation = 0;
+	Population.Reset(Params.Breeding.PopulationSize);
+	Population.GenerateRandomBatch(Params.Breeding.PopulationSize, FRandomStreamBatch(Params.Breeding.Seed, Generation, 0, ERandomStreamPurpose::Genesis));
+}
+
+void FHeadlessEvolution::Initialize(FGenePool&& InPopulation, int32 StartGeneration)
+{
+	Population = MoveTemp(InPopulation);
+	Generation = StartGeneration;
+}
+
+FHeadlessGenerationStats FHeadlessEvolution::RunGeneration()
+{
+	FHeadlessGenerationStats Stats;
+	Stats.Generation = Generation;
+
+	// Births never grow the arrays past MaxPopulation, so element references stay valid within a step
+	const int32 Capacity = FMath::Max(Population.Num(), Params.MaxPopulation);
+	Genes.Reset(Capacity);
+	States.Reset(Capacity);
+	Evaluations.Reset(Capacity);
+	for (int32 i = 0; i < Population.Num(); i++)
+	{
+		AddCreature(Population.Get(i));
+	}
+
+	FSimulationRandomStream Stream(Params.Breeding.Seed, 0, Generation, ERandomStreamPurpose::Creature);
+	const float DeltaTime = Params.TimeStep;
+	float Time = 0.0f;
+
+	// Same advance conditions as AEcosystemManager::CheckGenerationConditions
+	while (Time < Params.GenerationTimeLimit && Genes.Num() > Params.MinPopulation && Genes.Num() < Params.MaxPopulation)
+	{
+		const int32 NumAlive = Genes.Num();
+
+		for (int32 i = 0; i < NumAlive; i++)
+		{
+			FCreatureLifeState& State = States[i];
+
+			// Killed earlier in this step
+			if (FCreatureMetabolism::IsDead(State, Evaluations[i].Rates))
+			{
+				continue;
+			}
+
+			FCreatureMetabolism::StepLifeStats(State, Evaluations[i].Rates, DeltaTime);
+			if (FCreatureMetabolism::IsDead(State, Evaluations[i].Rates))
+			{
+				continue;
+			}
+
+			// Faster creatures that see further find food more often
+			const FCreatureGenes& CreatureGenes = Genes[i];
+			if (Stream.GetFraction() < Params.FoodEncounterRate * DeltaTime * CreatureGenes.Speed * CreatureGenes.VisionRange / 500.0f)
+			{
+				FCreatureMetabolism::ConsumeFood(State, Params.FoodValue);
+			}
+
+			// Meet another creature, handled like ACreature::OnInteractionSphereBeginOverlap
+			const int32 OtherIndex = Stream.RandRange(0, NumAlive - 1);
+			FCreatureLifeState& OtherState = States[OtherIndex];
+			if (OtherIndex == i || FCreatureMetabolism::IsDead(OtherState, Evaluations[OtherIndex].Rates))
+			{
+				continue;
+			}
+
+			const float Roll = Stream.GetFraction();
+			bool bWantsToMate = false;
+
+			switch (CreatureGenes.AggressionLevel)
+			{
+				case EAggressionLevel::Aggressive:
+				case EAggressionLevel::Predatory:
+					if (State.Energy > 30.0f && Roll < Params.FightEncounterRate * DeltaTime)
+					{
+						FCreatureMetabolism::ApplyDamage(OtherState, CreatureGenes.Strength * 10.0f, Genes[OtherIndex].DamageResistance);
+						State.Energy -= 5.0f;
+
+						if (OtherState.Health <= 0.0f)
+						{
+							State.CombatWins++;
+						}
+					}
+					break;
+
+				case EAggressionLevel::Peaceful:
+					bWantsToMate = true;
+					break;
+
+				default:
+					bWantsToMate = CreatureGenes.SocialTendency > 1.5f;
+					break;
+			}
+
+			if (bWantsToMate && Roll < Params.MateEncounterRate * DeltaTime &&
+				FCreatureMetabolism::CanReproduce(State, Evaluations[i].Rates) && FCreatureMetabolism::CanReproduce(OtherState, Evaluations[OtherIndex].Rates))
+			{
+				// Same crossover and mutation as ACreature::AttemptReproduction
+				FCreatureGenes OffspringGenes = FCreatureGenes::Crossover(CreatureGenes, Genes[OtherIndex], Stream);
+				OffspringGenes.Mutate(Stream, 0.1f, 0.2f);
+
+				FCreatureMetabolism::ApplyReproductionCost(State, CreatureGenes.ReproductionRate);
+				FCreatureMetabolism::ApplyReproductionCost(OtherState, Genes[OtherIndex].ReproductionRate);
+				Stats.Births++;
+
+				if (Genes.Num() < Params.MaxPopulation)
+				{
+					AddCreature(OffspringGenes);
+				}
+			}
+		}
+
+		// Remove the dead
+		for (int32 i = Genes.Num() - 1; i >= 0; i--)
+		{
+			if (FCreatureMetabolism::IsDead(States[i], Evaluations[i].Rates))
+			{
+				RemoveCreature(i, Stats);
+			}
+		}
+
+		Time += DeltaTime;
+	}
+
+	Stats.SimulatedSeconds = Time;
+	Stats.Population = Genes.Num();
+
+	// Snapshot the survivors, as GatherPopulationSnapshot does
+	FGenePool Survivors;
+	TArray<float> Fitness;
+	Survivors.Reset(Genes.Num());
+	Fitness.Reserve(Genes.Num());
+
+	double TotalFitness = 0.0;
+	for (int32 i = 0; i < Genes.Num(); i++)
+	{
+		const float CreatureFitness = Evaluations[i].GetFitness(States[i]);
+		Survivors.Add(Genes[i]);
+		Fitness.Add(CreatureFitness);
+		Stats.Sketch.Add(Genes[i], CreatureFitness);
+		TotalFitness += CreatureFitness;
+
+		if (CreatureFitness > Stats.MaxFitness)
+		{
+			Stats.MaxFitness = CreatureFitness;
+			Stats.BestGenes = Genes[i];
+		}
+	}
+
+	Stats.AverageFitness = Genes.Num() > 0 ? static_cast<float>(TotalFitness / Genes.Num()) : 0.0f;
+
+	// Sharing and novelty only reshape selection, the stats above stay raw fitness
+	if (Params.Speciation.IsEnabled())
+	{
+		Speciation.ClusterAndShare(Survivors, Fitness);
+		Stats.Species = Speciation.GetStats();
+	}
+
+	if (Params.Novelty.IsEnabled())
+	{
+		NoveltyArchive.ScoreAndArchive(Survivors, Fitness);
+	}
+
+	// Breed the next generation
+	Generation++;
+	FBreedingParams BreedingParams = Params.Breeding;
+	BreedingParams.Generation = Generation;
+
+	// Objectives are only needed when they are ranked separately
+	FFitnessObjectives Objectives;
+	if (BreedingParams.SelectionStrategy == ESelectionStrategy::NSGA2)
+	{
+		Objectives.Reset(Genes.Num());
+		for (int32 i = 0; i < Genes.Num(); i++)
+		{
+			Objectives.Add(Genes[i], States[i]);
+		}
+	}
+
+	FGenePool NextGeneration;
+	FGenerationBreeder::Breed(Survivors, Fitness, Objectives, BreedingParams, NextGeneration);
+	Population = MoveTemp(NextGeneration);
+
+	return Stats;
+}
+
+void FHeadlessEvolution::AddCreature(const FCreatureGenes& CreatureGenes)
+{
+	Genes.Add(CreatureGenes);
+	States.AddDefaulted();
+	Evaluations.Add(FitnessCache.Evaluate(CreatureGenes));
+}
+
+void FHeadlessEvolution::RemoveCreature(int32 Index, FHeadlessGenerationStats& Stats)
+{
+	Stats.Deaths++;
+
+	const float CreatureFitness = Evaluations[Index].GetFitness(States[Index]);
+	Stats.Sketch.Add(Genes[Index], CreatureFitness);
+
+	if (OnCreatureDeath)
+	{
+		FCreatureRecord Record;
+		Record.Genes = Genes[Index];
+		Record.FitnessScore = CreatureFitness;
+		Record.LifeTime = States[Index].Age;
+		Record.Generation = Generation;
+		Record.OffspringCount = States[Index].OffspringCount;
+		OnCreatureDeath(Record);
+	}
+
+	Genes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	States.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Evaluations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
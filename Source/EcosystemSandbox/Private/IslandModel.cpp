@@ -0,0 +1,284 @@
+#include "IslandModel.h"
+#include "Async/ParallelFor.h"
+
+uint64 FIslandModel::GetIslandSeed(uint64 Seed, int32 Island)
+{
+	return Island == 0 ? Seed : FSimulationRandomStream::MakeKey(Seed, Island, 0, ERandomStreamPurpose::Island);
+}
+
+FBreedingParams FIslandModel::MakeBreedingParams(const FIslandConfig& Config, uint64 Seed, int32 Island, int32 Generation)
+{
+	FBreedingParams Params;
+	Params.PopulationSize = Config.PopulationSize;
+	Params.MutationRate = Config.MutationRate;
+	Params.MutationStrength = Config.MutationStrength;
+	Params.MutationMode = Config.MutationMode;
+	Params.ElitePercentage = Config.ElitePercentage;
+	Params.SelectionStrategy = Config.SelectionStrategy;
+	Params.TournamentSize = Config.TournamentSize;
+	Params.Seed = GetIslandSeed(Seed, Island);
+	Params.Generation = Generation;
+	return Params;
+}
+
+bool FIslandModel::IsMigrationGeneration(const FMigrationParams& Params, int32 NumIslands, int32 Generation)
+{
+	return NumIslands > 1 && Params.Interval > 0 && Params.MigrantCount > 0 && Generation % Params.Interval == 0;
+}
+
+void FIslandModel::GetMigrationTargets(EMigrationTopology Topology, int32 NumIslands, int32 Source, FSimulationRandomStream& Stream, TArray<int32>& OutTargets)
+{
+	OutTargets.Reset();
+
+	if (NumIslands < 2)
+	{
+		return;
+	}
+
+	switch (Topology)
+	{
+		case EMigrationTopology::Ring:
+			OutTargets.Add((Source + 1) % NumIslands);
+			break;
+
+		case EMigrationTopology::FullyConnected:
+			for (int32 Island = 0; Island < NumIslands; Island++)
+			{
+				if (Island != Source)
+				{
+					OutTargets.Add(Island);
+				}
+			}
+			break;
+
+		case EMigrationTopology::Random:
+		{
+			// Any island but the source
+			int32 Target = Stream.RandRange(0, NumIslands - 2);
+			OutTargets.Add(Target >= Source ? Target + 1 : Target);
+			break;
+		}
+	}
+}
+
+void FIslandModel::Migrate(TConstArrayView<FGenePool*> Islands, const FMigrationParams& Params, uint64 Seed, int32 Generation)
+{
+	const int32 NumIslands = Islands.Num();
+
+	// Elites lead every bred gene pool, so the leading rows are the best genomes
+	TArray<FGenePool> Emigrants;
+	Emigrants.SetNum(NumIslands);
+	for (int32 Island = 0; Island < NumIslands; Island++)
+	{
+		const int32 Count = FMath::Min(Params.MigrantCount, Islands[Island]->Num());
+		Emigrants[Island].SetNumUninitialized(Count);
+		for (int32 i = 0; i < Count; i++)
+		{
+			Emigrants[Island].CopyRow(*Islands[Island], i, i);
+		}
+	}
+
+	// Immigrants fill each island from the back, never past its first half
+	TArray<int32> NextSlot;
+	NextSlot.SetNumUninitialized(NumIslands);
+	for (int32 Island = 0; Island < NumIslands; Island++)
+	{
+		NextSlot[Island] = Islands[Island]->Num() - 1;
+	}
+
+	FSimulationRandomStream Stream(Seed, 0, Generation, ERandomStreamPurpose::Migration);
+	TArray<int32> Targets;
+
+	for (int32 Source = 0; Source < NumIslands; Source++)
+	{
+		GetMigrationTargets(Params.Topology, NumIslands, Source, Stream, Targets);
+
+		for (int32 Target : Targets)
+		{
+			FGenePool& Destination = *Islands[Target];
+			const int32 FirstReplaceable = Destination.Num() / 2;
+
+			for (int32 i = 0; i < Emigrants[Source].Num() && NextSlot[Target] >= FirstReplaceable; i++)
+			{
+				Destination.CopyRow(Emigrants[Source], i, NextSlot[Target]--);
+			}
+		}
+	}
+}
+
+void FIslandModel::BreedIslands(TConstArrayView<FGenePool> Populations, TConstArrayView<TArray<float>> Fitness, TConstArrayView<FFitnessObjectives> Objectives, TConstArrayView<FIslandConfig> Configs,
+	const FMigrationParams& Migration, uint64 Seed, int32 Generation, TArray<FGenePool>& OutNextGenerations)
+{
+	check(Populations.Num() == Configs.Num() && Fitness.Num() == Configs.Num() && Objectives.Num() == Configs.Num());
+
+	const int32 NumIslands = Configs.Num();
+	OutNextGenerations.SetNum(NumIslands);
+
+	// Each island's breeder splits its own offspring into parallel chunks as well
+	ParallelFor(NumIslands, [&](int32 Island)
+	{
+		const FBreedingParams Params = MakeBreedingParams(Configs[Island], Seed, Island, Generation);
+		FGenerationBreeder::Breed(Populations[Island], Fitness[Island], Objectives[Island], Params, OutNextGenerations[Island]);
+	});
+
+	if (IsMigrationGeneration(Migration, NumIslands, Generation))
+	{
+		TArray<FGenePool*> Islands;
+		for (FGenePool& Island : OutNextGenerations)
+		{
+			Islands.Add(&Island);
+		}
+
+		Migrate(Islands, Migration, Seed, Generation);
+	}
+}
+
+FIslandEvolution::FIslandEvolution(const FHeadlessEvolutionParams& BaseParams, TConstArrayView<FIslandConfig> Configs, const FMigrationParams& InMigration)
+	: Migration(InMigration)
+	, Seed(BaseParams.Breeding.Seed)
+{
+	int32 TotalPopulation = 0;
+	for (const FIslandConfig& Config : Configs)
+	{
+		TotalPopulation += Config.PopulationSize;
+	}
+
+	for (int32 Island = 0; Island < Configs.Num(); Island++)
+	{
+		const FIslandConfig& Config = Configs[Island];
+		const float Share = static_cast<float>(Config.PopulationSize) / FMath::Max(1, TotalPopulation);
+
+		FHeadlessEvolutionParams Params = BaseParams;
+		Params.MinPopulation = FMath::RoundToInt(BaseParams.MinPopulation * Share);
+		Params.MaxPopulation = FMath::Max(1, FMath::RoundToInt(BaseParams.MaxPopulation * Share));
+		Params.Breeding = FIslandModel::MakeBreedingParams(Config, Seed, Island, 0);
+
+		Islands.Add(MakeUnique<FHeadlessEvolution>(Params));
+	}
+
+	IslandStats.SetNum(Islands.Num());
+	IslandDeaths.SetNum(Islands.Num());
+}
+
+void FIslandEvolution::InitializeRandom()
+{
+	for (TUniquePtr<FHeadlessEvolution>& Island : Islands)
+	{
+		Island->InitializeRandom();
+	}
+}
+
+void FIslandEvolution::Initialize(TArray<FGenePool>&& Populations, int32 StartGeneration)
+{
+	check(Populations.Num() == Islands.Num());
+
+	for (int32 Island = 0; Island < Islands.Num(); Island++)
+	{
+		Islands[Island]->Initialize(MoveTemp(Populations[Island]), StartGeneration);
+	}
+}
+
+FGenomeCacheStats FIslandEvolution::GetFitnessCacheStats() const
+{
+	FGenomeCacheStats Stats;
+	for (const TUniquePtr<FHeadlessEvolution>& Island : Islands)
+	{
+		const FGenomeCacheStats IslandCache = Island->GetFitnessCache().GetStats();
+		Stats.Hits += IslandCache.Hits;
+		Stats.Misses += IslandCache.Misses;
+		Stats.Entries += IslandCache.Entries;
+	}
+
+	Stats.HitRate = Stats.Hits + Stats.Misses > 0 ? static_cast<float>(Stats.Hits) / (Stats.Hits + Stats.Misses) : 0.0f;
+	return Stats;
+}
+
+int32 FIslandEvolution::GetNoveltyArchiveSize() const
+{
+	int32 Size = 0;
+	for (const TUniquePtr<FHeadlessEvolution>& Island : Islands)
+	{
+		Size += Island->GetNoveltyArchive().Num();
+	}
+	return Size;
+}
+
+FHeadlessGenerationStats FIslandEvolution::RunGeneration()
+{
+	FHeadlessGenerationStats Stats;
+	Stats.Generation = GetGeneration();
+
+	// Deaths are buffered per island and reported from this thread afterwards
+	for (int32 Island = 0; Island < Islands.Num(); Island++)
+	{
+		IslandDeaths[Island].Reset();
+		Islands[Island]->OnCreatureDeath = nullptr;
+
+		if (OnCreatureDeath)
+		{
+			Islands[Island]->OnCreatureDeath = [&Deaths = IslandDeaths[Island]](const FCreatureRecord& Record)
+			{
+				Deaths.Add(Record);
+			};
+		}
+	}
+
+	ParallelFor(Islands.Num(), [this](int32 Island)
+	{
+		IslandStats[Island] = Islands[Island]->RunGeneration();
+	});
+
+	if (OnCreatureDeath)
+	{
+		for (const TArray<FCreatureRecord>& Deaths : IslandDeaths)
+		{
+			for (const FCreatureRecord& Record : Deaths)
+			{
+				OnCreatureDeath(Record);
+			}
+		}
+	}
+
+	double TotalFitness = 0.0;
+	for (const FHeadlessGenerationStats& Island : IslandStats)
+	{
+		Stats.Population += Island.Population;
+		Stats.Births += Island.Births;
+		Stats.Deaths += Island.Deaths;
+		Stats.SimulatedSeconds = FMath::Max(Stats.SimulatedSeconds, Island.SimulatedSeconds);
+		TotalFitness += static_cast<double>(Island.AverageFitness) * Island.Population;
+		Stats.Sketch.Merge(Island.Sketch);
+
+		if (Island.MaxFitness > Stats.MaxFitness)
+		{
+			Stats.MaxFitness = Island.MaxFitness;
+			Stats.BestGenes = Island.BestGenes;
+		}
+	}
+
+	Stats.AverageFitness = Stats.Population > 0 ? static_cast<float>(TotalFitness / Stats.Population) : 0.0f;
+
+	for (int32 Island = 0; Island < IslandStats.Num(); Island++)
+	{
+		for (FSpeciesStats Species : IslandStats[Island].Species)
+		{
+			Species.Island = Island;
+			Stats.Species.Add(MoveTemp(Species));
+		}
+	}
+
+	// Every island has bred the same next generation number
+	const int32 NextGeneration = GetGeneration();
+	if (FIslandModel::IsMigrationGeneration(Migration, Islands.Num(), NextGeneration))
+	{
+		TArray<FGenePool*> Populations;
+		for (TUniquePtr<FHeadlessEvolution>& Island : Islands)
+		{
+			Populations.Add(&Island->GetMutablePopulation());
+		}
+
+		FIslandModel::Migrate(Populations, Migration, Seed, NextGeneration);
+	}
+
+	return Stats;
+}
@@ -0,0 +1,223 @@
+#include "LineageArena.h"
+
+uint32 FLineageArena::Add(uint32 Parent1, uint32 Parent2, int32 Generation, float BirthTime)
+{
+	check(Parent1 == InvalidId || IsValidId(Parent1));
+	check(Parent2 == InvalidId || IsValidId(Parent2));
+
+	return static_cast<uint32>(Records.AddElement({ Parent1, Parent2, Generation, BirthTime }));
+}
+
+void FLineageArena::GetAncestors(uint32 Id, int32 MaxDepth, TArray<uint32>& OutAncestors) const
+{
+	OutAncestors.Reset();
+	if (!IsValidId(Id))
+	{
+		return;
+	}
+
+	// Breadth first, one parent link per depth
+	TSet<uint32> Visited;
+	int32 LevelStart = 0;
+	auto Visit = [&](uint32 Parent)
+	{
+		bool bAlreadyVisited = false;
+		if (Parent != InvalidId)
+		{
+			Visited.Add(Parent, &bAlreadyVisited);
+			if (!bAlreadyVisited)
+			{
+				OutAncestors.Add(Parent);
+			}
+		}
+	};
+
+	Visit(Records[Id].Parent1);
+	Visit(Records[Id].Parent2);
+
+	for (int32 Depth = 1; Depth < MaxDepth && LevelStart < OutAncestors.Num(); Depth++)
+	{
+		const int32 LevelEnd = OutAncestors.Num();
+		for (int32 i = LevelStart; i < LevelEnd; i++)
+		{
+			const FLineageRecord& Record = Records[OutAncestors[i]];
+			Visit(Record.Parent1);
+			Visit(Record.Parent2);
+		}
+		LevelStart = LevelEnd;
+	}
+}
+
+uint32 FLineageArena::FindCommonAncestor(uint32 A, uint32 B) const
+{
+	if (!IsValidId(A) || !IsValidId(B))
+	{
+		return InvalidId;
+	}
+
+	// Expands both ancestries newest first. Everything that can reach an id is newer than it,
+	// so an id has been reached from every side it will ever be by the time it is popped.
+	constexpr uint8 FromA = 1;
+	constexpr uint8 FromB = 2;
+
+	TMap<uint32, uint8> Reached;
+	TArray<uint32> Heap;
+
+	auto Reach = [&](uint32 Id, uint8 Sides)
+	{
+		if (Id == InvalidId)
+		{
+			return;
+		}
+
+		uint8& ReachedSides = Reached.FindOrAdd(Id);
+		if (ReachedSides == 0)
+		{
+			Heap.HeapPush(Id, TGreater<uint32>());
+		}
+		ReachedSides |= Sides;
+	};
+
+	Reach(A, FromA);
+	Reach(B, FromB);
+
+	while (Heap.Num() > 0)
+	{
+		uint32 Id;
+		Heap.HeapPop(Id, TGreater<uint32>(), EAllowShrinking::No);
+
+		const uint8 Sides = Reached[Id];
+		if (Sides == (FromA | FromB))
+		{
+			return Id;
+		}
+
+		Reach(Records[Id].Parent1, Sides);
+		Reach(Records[Id].Parent2, Sides);
+	}
+
+	return InvalidId;
+}
+
+void FLineageArena::CountDescendantsPerFounder(TConstArrayView<uint32> Ids, TMap<uint32, int32>& OutCounts) const
+{
+	OutCounts.Reset();
+
+	// Every ancestor of the queried ids
+	TBitArray<> InClosure(false, Num());
+	TArray<uint32> Stack;
+	auto Push = [&](uint32 Id)
+	{
+		if (Id != InvalidId && !InClosure[Id])
+		{
+			InClosure[Id] = true;
+			Stack.Add(Id);
+		}
+	};
+
+	for (uint32 Id : Ids)
+	{
+		if (IsValidId(Id))
+		{
+			Push(Id);
+		}
+	}
+
+	while (Stack.Num() > 0)
+	{
+		const FLineageRecord& Record = Records[Stack.Pop(EAllowShrinking::No)];
+		Push(Record.Parent1);
+		Push(Record.Parent2);
+	}
+
+	// Compact slots in id order, founders also get a bit each
+	TArray<int32> Slots;
+	Slots.SetNumUninitialized(Num());
+	TArray<uint32> Founders;
+	int32 NumSlots = 0;
+
+	for (TConstSetBitIterator<> It(InClosure); It; ++It)
+	{
+		Slots[It.GetIndex()] = NumSlots++;
+		if (IsFounder(It.GetIndex()))
+		{
+			Founders.Add(It.GetIndex());
+		}
+	}
+
+	if (Founders.Num() == 0)
+	{
+		return;
+	}
+
+	// Founder sets flow from parents to offspring, id order is birth order so parents are always done first
+	const int32 NumWords = FMath::DivideAndRoundUp(Founders.Num(), 64);
+	TArray<uint64> FounderBits;
+	FounderBits.SetNumZeroed(NumSlots * NumWords);
+
+	int32 NextFounder = 0;
+	for (TConstSetBitIterator<> It(InClosure); It; ++It)
+	{
+		uint64* Bits = &FounderBits[Slots[It.GetIndex()] * NumWords];
+		const FLineageRecord& Record = Records[It.GetIndex()];
+
+		if (Record.Parent1 == InvalidId && Record.Parent2 == InvalidId)
+		{
+			Bits[NextFounder / 64] |= 1ull << (NextFounder % 64);
+			NextFounder++;
+			continue;
+		}
+
+		for (uint32 Parent : { Record.Parent1, Record.Parent2 })
+		{
+			if (Parent != InvalidId)
+			{
+				const uint64* ParentBits = &FounderBits[Slots[Parent] * NumWords];
+				for (int32 Word = 0; Word < NumWords; Word++)
+				{
+					Bits[Word] |= ParentBits[Word];
+				}
+			}
+		}
+	}
+
+	for (uint32 Id : Ids)
+	{
+		if (!IsValidId(Id))
+		{
+			continue;
+		}
+
+		const uint64* Bits = &FounderBits[Slots[Id] * NumWords];
+		for (int32 Word = 0; Word < NumWords; Word++)
+		{
+			for (uint64 Remaining = Bits[Word]; Remaining != 0; Remaining &= Remaining - 1)
+			{
+				OutCounts.FindOrAdd(Founders[Word * 64 + FMath::CountTrailingZeros64(Remaining)])++;
+			}
+		}
+	}
+}
+
+void FLineageArena::Reset()
+{
+	Records.Empty();
+}
+
+void FLineageArena::CopyTo(TArray<FLineageRecord>& OutRecords) const
+{
+	OutRecords.SetNumUninitialized(Records.Num());
+	for (int32 Id = 0; Id < Records.Num(); Id++)
+	{
+		OutRecords[Id] = Records[Id];
+	}
+}
+
+void FLineageArena::Load(TConstArrayView<FLineageRecord> InRecords)
+{
+	Records.Empty();
+	for (const FLineageRecord& Record : InRecords)
+	{
+		Records.AddElement(Record);
+	}
+}
@@ -0,0 +1,334 @@
+#include "MultiObjectiveSelection.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	constexpr int32 NumObjectives = FFitnessObjectives::NumObjectives;
+
+	// Populations up to this size use an N^2 bit dominance matrix (32 MB at the limit), larger ones compare rows pairwise
+	constexpr int32 MaxDominanceMatrixRows = 16384;
+
+	// Matrix bit columns filled per parallel task
+	constexpr int32 MatrixWordsPerTask = 16;
+
+	// Maximization: A is no worse in every objective and better in at least one
+	FORCEINLINE bool Dominates(const float* A, const float* B)
+	{
+		bool bBetter = false;
+		for (int32 Objective = 0; Objective < NumObjectives; Objective++)
+		{
+			if (A[Objective] < B[Objective])
+			{
+				return false;
+			}
+			bBetter |= A[Objective] > B[Objective];
+		}
+		return bBetter;
+	}
+}
+
+void FFitnessObjectives::Reset(int32 ExpectedNum)
+{
+	for (TArray<float>& Column : Columns)
+	{
+		Column.Reset(ExpectedNum);
+	}
+}
+
+void FFitnessObjectives::Add(const FCreatureGenes& Genes, const FCreatureLifeState& State)
+{
+	Columns[static_cast<int32>(EFitnessObjective::Survival)].Add(State.Age * Genes.GetSurvivalFitnessRate());
+	Columns[static_cast<int32>(EFitnessObjective::Offspring)].Add(static_cast<float>(State.OffspringCount));
+	Columns[static_cast<int32>(EFitnessObjective::Resources)].Add(State.ResourcesGathered);
+	Columns[static_cast<int32>(EFitnessObjective::CombatWins)].Add(static_cast<float>(State.CombatWins));
+	Columns[static_cast<int32>(EFitnessObjective::SizeEfficiency)].Add(1.0f - FMath::Abs(Genes.Size - 1.0f));
+	Columns[static_cast<int32>(EFitnessObjective::Intelligence)].Add(Genes.Intelligence);
+	Columns[static_cast<int32>(EFitnessObjective::Endurance)].Add(Genes.Endurance);
+}
+
+int32 FMultiObjectiveSelection::SortFronts(const FFitnessObjectives& Objectives, TArray<int32>& OutFront)
+{
+	const int32 NumRows = Objectives.Num();
+	OutFront.SetNumUninitialized(NumRows);
+
+	if (NumRows == 0)
+	{
+		return 0;
+	}
+
+	// Lexicographically descending, so a row can only be dominated by rows before it
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumRows);
+	for (int32 i = 0; i < NumRows; i++)
+	{
+		Order[i] = i;
+	}
+
+	Order.Sort([&Objectives](int32 A, int32 B)
+	{
+		for (const TArray<float>& Column : Objectives.Columns)
+		{
+			if (Column[A] != Column[B])
+			{
+				return Column[A] > Column[B];
+			}
+		}
+		return A < B;
+	});
+
+	// Everything below works on sorted positions, dominance checks read whole rows
+	TArray<float> Rows;
+	Rows.SetNumUninitialized(NumRows * NumObjectives);
+	for (int32 Objective = 0; Objective < NumObjectives; Objective++)
+	{
+		const TArray<float>& Column = Objectives.Columns[Objective];
+		for (int32 Position = 0; Position < NumRows; Position++)
+		{
+			Rows[Position * NumObjectives + Objective] = Column[Order[Position]];
+		}
+	}
+
+	// Bit Q of position P is set when position Q is no worse than P in every objective
+	const bool bUseMatrix = NumRows <= MaxDominanceMatrixRows;
+	const int32 NumWords = FMath::DivideAndRoundUp(NumRows, 64);
+	TArray<uint64> NoWorse;
+
+	if (bUseMatrix)
+	{
+		NoWorse.Init(~0ull, NumRows * NumWords);
+
+		TArray<int32> ObjectiveOrders[NumObjectives];
+		for (int32 Objective = 0; Objective < NumObjectives; Objective++)
+		{
+			TArray<int32>& ObjectiveOrder = ObjectiveOrders[Objective];
+			ObjectiveOrder.SetNumUninitialized(NumRows);
+			for (int32 Position = 0; Position < NumRows; Position++)
+			{
+				ObjectiveOrder[Position] = Position;
+			}
+
+			ObjectiveOrder.Sort([&Rows, Objective](int32 A, int32 B)
+			{
+				return Rows[A * NumObjectives + Objective] > Rows[B * NumObjectives + Objective];
+			});
+		}
+
+		// Every task owns a range of bit columns and intersects the "no worse in this objective" prefixes into it
+		const int32 NumTasks = FMath::DivideAndRoundUp(NumWords, MatrixWordsPerTask);
+		ParallelFor(NumTasks, [&](int32 Task)
+		{
+			const int32 WordBegin = Task * MatrixWordsPerTask;
+			const int32 WordEnd = FMath::Min(WordBegin + MatrixWordsPerTask, NumWords);
+
+			uint64 Prefix[MatrixWordsPerTask];
+
+			for (int32 Objective = 0; Objective < NumObjectives; Objective++)
+			{
+				const TArray<int32>& ObjectiveOrder = ObjectiveOrders[Objective];
+				FMemory::Memzero(Prefix);
+
+				for (int32 GroupStart = 0; GroupStart < NumRows;)
+				{
+					// Ties are no worse than each other
+					const float Value = Rows[ObjectiveOrder[GroupStart] * NumObjectives + Objective];
+					int32 GroupEnd = GroupStart;
+					for (; GroupEnd < NumRows && Rows[ObjectiveOrder[GroupEnd] * NumObjectives + Objective] == Value; GroupEnd++)
+					{
+						const int32 Word = ObjectiveOrder[GroupEnd] / 64;
+						if (Word >= WordBegin && Word < WordEnd)
+						{
+							Prefix[Word - WordBegin] |= 1ull << (ObjectiveOrder[GroupEnd] % 64);
+						}
+					}
+
+					// Only bits before a position are ever read
+					for (int32 i = GroupStart; i < GroupEnd; i++)
+					{
+						const int32 Position = ObjectiveOrder[i];
+						uint64* Bits = &NoWorse[Position * NumWords];
+						const int32 LastWord = FMath::Min(WordEnd, Position / 64 + 1);
+						for (int32 Word = WordBegin; Word < LastWord; Word++)
+						{
+							Bits[Word] &= Prefix[Word - WordBegin];
+						}
+					}
+
+					GroupStart = GroupEnd;
+				}
+			}
+		});
+	}
+
+	// ENS-BS: a row dominated by front k is also dominated by every better front, so its front is found by binary search
+	TArray<TArray<int32>> FrontMembers;
+	TArray<TArray<uint64>> FrontBits;
+	int32 EqualStart = 0;
+
+	for (int32 Position = 0; Position < NumRows; Position++)
+	{
+		const float* Candidate = &Rows[Position * NumObjectives];
+
+		// Identical rows are adjacent and never dominate each other
+		if (Position > 0 && FMemory::Memcmp(Candidate, Candidate - NumObjectives, NumObjectives * sizeof(float)) != 0)
+		{
+			EqualStart = Position;
+		}
+
+		auto IsDominatedBy = [&](int32 Front)
+		{
+			if (bUseMatrix)
+			{
+				// Rows no worse in every objective and before the identical ones are exactly the dominating rows
+				const uint64* Bits = &NoWorse[Position * NumWords];
+				const uint64* Members = FrontBits[Front].GetData();
+				const int32 FullWords = EqualStart / 64;
+
+				for (int32 Word = 0; Word < FullWords; Word++)
+				{
+					if (Bits[Word] & Members[Word])
+					{
+						return true;
+					}
+				}
+
+				const uint64 TailMask = (1ull << (EqualStart % 64)) - 1;
+				return (Bits[FullWords] & Members[FullWords] & TailMask) != 0;
+			}
+
+			// The most recently added members are the most similar, check them first
+			const TArray<int32>& Members = FrontMembers[Front];
+			for (int32 i = Members.Num() - 1; i >= 0; i--)
+			{
+				if (Dominates(&Rows[Members[i] * NumObjectives], Candidate))
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+
+		int32 Low = 0;
+		int32 High = FrontMembers.Num();
+		while (Low < High)
+		{
+			const int32 Mid = Low + (High - Low) / 2;
+			if (IsDominatedBy(Mid))
+			{
+				Low = Mid + 1;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+
+		if (Low == FrontMembers.Num())
+		{
+			FrontMembers.AddDefaulted();
+			if (bUseMatrix)
+			{
+				FrontBits.AddDefaulted_GetRef().SetNumZeroed(NumWords);
+			}
+		}
+
+		FrontMembers[Low].Add(Position);
+		if (bUseMatrix)
+		{
+			FrontBits[Low][Position / 64] |= 1ull << (Position % 64);
+		}
+
+		OutFront[Order[Position]] = Low;
+	}
+
+	return FrontMembers.Num();
+}
+
+void FMultiObjectiveSelection::CrowdingDistance(const FFitnessObjectives& Objectives, TConstArrayView<int32> Front, int32 NumFronts, TArray<float>& OutDistance)
+{
+	const int32 NumRows = Objectives.Num();
+	check(Front.Num() == NumRows);
+
+	OutDistance.SetNumZeroed(NumRows);
+
+	// Group rows by front with a counting sort
+	TArray<int32> FrontStart;
+	FrontStart.SetNumZeroed(NumFronts + 1);
+	for (int32 i = 0; i < NumRows; i++)
+	{
+		FrontStart[Front[i] + 1]++;
+	}
+	for (int32 f = 0; f < NumFronts; f++)
+	{
+		FrontStart[f + 1] += FrontStart[f];
+	}
+
+	TArray<int32> Grouped;
+	Grouped.SetNumUninitialized(NumRows);
+	{
+		TArray<int32> Next = FrontStart;
+		for (int32 i = 0; i < NumRows; i++)
+		{
+			Grouped[Next[Front[i]]++] = i;
+		}
+	}
+
+	for (int32 f = 0; f < NumFronts; f++)
+	{
+		TArrayView<int32> Members(Grouped.GetData() + FrontStart[f], FrontStart[f + 1] - FrontStart[f]);
+
+		if (Members.Num() <= 2)
+		{
+			for (int32 Row : Members)
+			{
+				OutDistance[Row] = TNumericLimits<float>::Max();
+			}
+			continue;
+		}
+
+		for (int32 Objective = 0; Objective < NumObjectives; Objective++)
+		{
+			const TArray<float>& Column = Objectives.Columns[Objective];
+
+			Algo::Sort(Members, [&Column](int32 A, int32 B)
+			{
+				return Column[A] != Column[B] ? Column[A] < Column[B] : A < B;
+			});
+
+			const float Range = Column[Members.Last()] - Column[Members[0]];
+			OutDistance[Members[0]] = TNumericLimits<float>::Max();
+			OutDistance[Members.Last()] = TNumericLimits<float>::Max();
+
+			if (Range <= 0.0f)
+			{
+				continue;
+			}
+
+			for (int32 i = 1; i < Members.Num() - 1; i++)
+			{
+				float& Distance = OutDistance[Members[i]];
+				if (Distance < TNumericLimits<float>::Max())
+				{
+					Distance += (Column[Members[i + 1]] - Column[Members[i - 1]]) / Range;
+				}
+			}
+		}
+	}
+}
+
+void FMultiObjectiveSelection::ComputeSelectionScores(const FFitnessObjectives& Objectives, TArray<float>& OutScores)
+{
+	TArray<int32> Front;
+	const int32 NumFronts = SortFronts(Objectives, Front);
+
+	TArray<float> Distance;
+	CrowdingDistance(Objectives, Front, NumFronts, Distance);
+
+	// Crowding maps into [0, 0.5], below the gap to the next front
+	OutScores.SetNumUninitialized(Objectives.Num());
+	for (int32 i = 0; i < Objectives.Num(); i++)
+	{
+		const float Crowding = Distance[i] == TNumericLimits<float>::Max() ? 1.0f : Distance[i] / (1.0f + Distance[i]);
+		OutScores[i] = static_cast<float>(NumFronts - Front[i]) + 0.5f * Crowding;
+	}
+}
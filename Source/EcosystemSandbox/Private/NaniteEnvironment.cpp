@@ -3,6 +3,7 @@
 #include "Components/InstancedStaticMeshComponent.h"
 #include "GeometryCollection/GeometryCollectionComponent.h"
 #include "Engine/World.h"
+#include "EcosystemClockSubsystem.h"
 #include "Engine/Engine.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "PhysicsEngine/BodySetup.h"
@@ -31,11 +32,12 @@ void ANaniteEnvironment::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Handle regrowth
-	if (bEnableRegrowth && GetWorld()->GetTimeSeconds() - LastRegrowthCheck > RegrowthCheckInterval)
+	// Handle regrowth, on simulated time so it keeps pace with the rest of the ecosystem
+	const double Now = UEcosystemClockSubsystem::GetSimulationSeconds(GetWorld());
+	if (bEnableRegrowth && Now - LastRegrowthCheck > RegrowthCheckInterval)
 	{
 		RegenerateDestroyedFoliage();
-		LastRegrowthCheck = GetWorld()->GetTimeSeconds();
+		LastRegrowthCheck = Now;
 	}
 }
 
@@ -116,15 +118,17 @@ void ANaniteEnvironment::GenerateFoliage()
 		
 		for (int32 i = 0; i < Config.InstanceCount; i++)
 		{
-			SpawnFoliageInstance(Config, ConfigIndex);
+			SpawnFoliageInstance(Config, ConfigIndex, i);
 		}
 	}
 }
 
-void ANaniteEnvironment::SpawnFoliageInstance(const FNaniteFoliageConfig& Config, int32 ConfigIndex)
+void ANaniteEnvironment::SpawnFoliageInstance(const FNaniteFoliageConfig& Config, int32 ConfigIndex, int32 InstanceIndex)
 {
+	FSimulationRandomStream Stream(RandomSeed, InstanceIndex, ConfigIndex, ERandomStreamPurpose::Foliage);
+
 	// Get random position
-	FVector Position = GetRandomPositionInRadius(Config.SpawnRadius);
+	FVector Position = GetRandomPositionInRadius(Config.SpawnRadius, Stream);
 	
 	if (!IsValidSpawnLocation(Position))
 	{
@@ -134,10 +138,10 @@ void ANaniteEnvironment::SpawnFoliageInstance(const FNaniteFoliageConfig& Config
 	// Create transform
 	FTransform InstanceTransform;
 	InstanceTransform.SetLocation(Position);
-	InstanceTransform.SetRotation(FQuat::MakeFromEuler(FVector(0, 0, FMath::RandRange(0.0f, 360.0f))));
+	InstanceTransform.SetRotation(FQuat::MakeFromEuler(FVector(0, 0, Stream.FRandRange(0.0f, 360.0f))));
 	
 	// Random scale
-	float Scale = FMath::RandRange(Config.ScaleRange.X, Config.ScaleRange.Y);
+	float Scale = Stream.FRandRange(Config.ScaleRange.X, Config.ScaleRange.Y);
 	InstanceTransform.SetScale3D(FVector(Scale));
 
 	// Add to instanced component
@@ -240,7 +244,8 @@ void ANaniteEnvironment::ConvertToDestructible(int32 InstanceIndex, const FNanit
 		GeometryComponent->OnChaosBreakEvent.AddDynamic(this, &ANaniteEnvironment::OnDestructibleBreak);
 
 		// Apply initial impulse to make it fall
-		FVector ImpulseDirection = FVector(FMath::RandRange(-1.0f, 1.0f), FMath::RandRange(-1.0f, 1.0f), -1.0f).GetSafeNormal();
+		FSimulationRandomStream Stream(RandomSeed, InstanceIndex, DestructibleComponents.Num(), ERandomStreamPurpose::Destruction);
+		FVector ImpulseDirection = FVector(Stream.FRandRange(-1.0f, 1.0f), Stream.FRandRange(-1.0f, 1.0f), -1.0f).GetSafeNormal();
 		GeometryComponent->AddImpulse(ImpulseDirection * 1000.0f);
 
 		DestructibleComponents.Add(GeometryComponent);
@@ -397,10 +402,10 @@ void ANaniteEnvironment::ResetEnvironment()
 	GenerateFoliage();
 }
 
-FVector ANaniteEnvironment::GetRandomPositionInRadius(float Radius) const
+FVector ANaniteEnvironment::GetRandomPositionInRadius(float Radius, FSimulationRandomStream& Stream) const
 {
-	float Angle = FMath::RandRange(0.0f, 2.0f * PI);
-	float Distance = FMath::RandRange(100.0f, Radius);
+	float Angle = Stream.FRandRange(0.0f, 2.0f * PI);
+	float Distance = Stream.FRandRange(100.0f, Radius);
 	
 	FVector Offset = FVector(
 		FMath::Cos(Angle) * Distance,
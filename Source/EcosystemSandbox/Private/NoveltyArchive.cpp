@@ -0,0 +1,198 @@
+#include "NoveltyArchive.h"
+#include "GeneticSelection.h"
+#include "SimulationRandom.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	constexpr int32 NumTraits = FGenePool::NumTraits;
+
+	FORCEINLINE float SquaredDistance(const float* A, const float* B)
+	{
+		float Sum = 0.0f;
+		for (int32 Trait = 0; Trait < NumTraits; Trait++)
+		{
+			const float Delta = A[Trait] - B[Trait];
+			Sum += Delta * Delta;
+		}
+		return Sum;
+	}
+}
+
+FNoveltyArchive::FNoveltyArchive(const FNoveltySearchParams& InParams)
+	: Params(InParams)
+{
+	FSimulationRandomStream Stream(Params.Seed, 0, 0, ERandomStreamPurpose::Novelty);
+
+	// Gaussian directions keep the projections distance preserving in every direction
+	Directions.SetNumUninitialized(NumTables * NumProjections * NumTraits);
+	for (float& Component : Directions)
+	{
+		Component = Stream.GetGaussian();
+	}
+
+	Offsets.SetNumUninitialized(NumTables * NumProjections);
+	for (float& Offset : Offsets)
+	{
+		Offset = Stream.FRandRange(0.0f, BucketWidth);
+	}
+}
+
+void FNoveltyArchive::Normalize(const FGenePool& Pool, int32 Row, float* OutTraits)
+{
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		OutTraits[TraitIndex] = FGeneTraits::Table[TraitIndex].Normalize(Pool.Traits[TraitIndex][Row]);
+	});
+}
+
+float FNoveltyArchive::GetMaxDistance()
+{
+	return FMath::Sqrt(static_cast<float>(NumTraits));
+}
+
+uint64 FNoveltyArchive::GetBucketKey(int32 Table, const float* Traits) const
+{
+	uint64 Key = static_cast<uint64>(Table);
+	for (int32 Projection = 0; Projection < NumProjections; Projection++)
+	{
+		const int32 Index = Table * NumProjections + Projection;
+		const float* Direction = &Directions[Index * NumTraits];
+
+		float Dot = Offsets[Index];
+		for (int32 Trait = 0; Trait < NumTraits; Trait++)
+		{
+			Dot += Direction[Trait] * Traits[Trait];
+		}
+
+		const int32 Cell = FMath::FloorToInt32(Dot / BucketWidth);
+		Key = FSimulationRandomStream::Mix(Key ^ (static_cast<uint32>(Cell) + 0x9E3779B97F4A7C15ull * (Projection + 1)));
+	}
+	return Key;
+}
+
+void FNoveltyArchive::Add(const float* Traits)
+{
+	const int32 Entry = Num();
+	Points.Append(Traits, NumTraits);
+
+	for (int32 Table = 0; Table < NumTables; Table++)
+	{
+		Buckets[Table].FindOrAdd(GetBucketKey(Table, Traits)).Add(Entry);
+	}
+}
+
+float FNoveltyArchive::GetNovelty(const float* Traits) const
+{
+	const int32 NumNeighbors = FMath::Max(1, Params.NumNeighbors);
+
+	TArray<int32, TInlineAllocator<NumTables * MaxBucketScan>> Candidates;
+	for (int32 Table = 0; Table < NumTables; Table++)
+	{
+		if (const TArray<int32>* Bucket = Buckets[Table].Find(GetBucketKey(Table, Traits)))
+		{
+			const int32 First = FMath::Max(0, Bucket->Num() - MaxBucketScan);
+			Candidates.Append(Bucket->GetData() + First, Bucket->Num() - First);
+		}
+	}
+
+	// The same entry usually shares a bucket in several tables
+	Candidates.Sort();
+
+	// Squared distances of the nearest candidates, ascending
+	TArray<float, TInlineAllocator<32>> Nearest;
+	for (int32 i = 0; i < Candidates.Num(); i++)
+	{
+		if (i > 0 && Candidates[i] == Candidates[i - 1])
+		{
+			continue;
+		}
+
+		const float Distance = SquaredDistance(Traits, &Points[Candidates[i] * NumTraits]);
+		if (Nearest.Num() == NumNeighbors && Distance >= Nearest.Last())
+		{
+			continue;
+		}
+
+		if (Nearest.Num() == NumNeighbors)
+		{
+			Nearest.Pop(EAllowShrinking::No);
+		}
+
+		int32 Insert = Nearest.Num();
+		while (Insert > 0 && Nearest[Insert - 1] > Distance)
+		{
+			Insert--;
+		}
+		Nearest.Insert(Distance, Insert);
+	}
+
+	// Neighbours in no shared bucket are far away
+	float Sum = (NumNeighbors - Nearest.Num()) * GetMaxDistance();
+	for (float Distance : Nearest)
+	{
+		Sum += FMath::Sqrt(Distance);
+	}
+
+	return Sum / NumNeighbors;
+}
+
+void FNoveltyArchive::ComputeNovelty(const FGenePool& Population, TArray<float>& OutNovelty) const
+{
+	OutNovelty.SetNumUninitialized(Population.Num());
+
+	ParallelFor(Population.Num(), [&](int32 Row)
+	{
+		float Traits[NumTraits];
+		Normalize(Population, Row, Traits);
+		OutNovelty[Row] = GetNovelty(Traits);
+	});
+}
+
+void FNoveltyArchive::ScoreAndArchive(const FGenePool& Population, TArray<float>& InOutFitness)
+{
+	check(Population.Num() == InOutFitness.Num());
+
+	if (Population.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<float> Novelty;
+	ComputeNovelty(Population, Novelty);
+
+	// Both terms are scaled to [0, 1] so Weight means the same for any fitness range
+	float MaxFitness = 0.0f;
+	float MaxNovelty = 0.0f;
+	for (int32 i = 0; i < Population.Num(); i++)
+	{
+		MaxFitness = FMath::Max(MaxFitness, InOutFitness[i]);
+		MaxNovelty = FMath::Max(MaxNovelty, Novelty[i]);
+	}
+
+	const float Weight = FMath::Clamp(Params.Weight, 0.0f, 1.0f);
+	for (int32 i = 0; i < Population.Num(); i++)
+	{
+		const float FitnessTerm = MaxFitness > 0.0f ? InOutFitness[i] / MaxFitness : 0.0f;
+		const float NoveltyTerm = MaxNovelty > 0.0f ? Novelty[i] / MaxNovelty : 0.0f;
+		InOutFitness[i] = (1.0f - Weight) * FitnessTerm + Weight * NoveltyTerm;
+	}
+
+	const int32 ArchiveCount = FMath::CeilToInt32(Population.Num() * FMath::Clamp(Params.ArchiveFraction, 0.0f, 1.0f));
+	for (int32 Row : FGeneticSelection::SelectTopK(Novelty, ArchiveCount))
+	{
+		float Traits[NumTraits];
+		Normalize(Population, Row, Traits);
+		Add(Traits);
+	}
+}
+
+void FNoveltyArchive::Reset()
+{
+	Points.Reset();
+	for (TMap<uint64, TArray<int32>>& Table : Buckets)
+	{
+		Table.Reset();
+	}
+}
@@ -0,0 +1,83 @@
+#include "PackedGenome.h"
+
+uint16 FPackedGenome::QuantizeTrait(EGeneTrait Trait, float Value)
+{
+	return static_cast<uint16>(FMath::RoundToInt(FGeneTraits::Get(Trait).Normalize(Value) * 65535.0f));
+}
+
+float FPackedGenome::DequantizeTrait(EGeneTrait Trait, uint16 Quantized)
+{
+	const FGeneTraitDescriptor& Descriptor = FGeneTraits::Get(Trait);
+	return Descriptor.Min + Descriptor.GetRange() * (Quantized / 65535.0f);
+}
+
+uint8 FPackedGenome::QuantizeStepSize(float Value)
+{
+	const float LogMin = FMath::Loge(FCreatureGenes::MinStepSize);
+	const float LogMax = FMath::Loge(FCreatureGenes::MaxStepSize);
+	const float Alpha = FMath::Clamp((FMath::Loge(FMath::Max(Value, FCreatureGenes::MinStepSize)) - LogMin) / (LogMax - LogMin), 0.0f, 1.0f);
+	return static_cast<uint8>(FMath::RoundToInt(Alpha * 255.0f));
+}
+
+float FPackedGenome::DequantizeStepSize(uint8 Quantized)
+{
+	const float LogMin = FMath::Loge(FCreatureGenes::MinStepSize);
+	const float LogMax = FMath::Loge(FCreatureGenes::MaxStepSize);
+	return FMath::Exp(LogMin + (LogMax - LogMin) * (Quantized / 255.0f));
+}
+
+FPackedGenome FPackedGenome::Pack(const FCreatureGenes& Genes)
+{
+	FPackedGenome Packed;
+	for (int32 Trait = 0; Trait < FGeneTraits::Num; Trait++)
+	{
+		const EGeneTrait GeneTrait = static_cast<EGeneTrait>(Trait);
+		Packed.Traits[Trait] = QuantizeTrait(GeneTrait, FGeneTraits::GetValue(Genes, GeneTrait));
+	}
+
+	Packed.Enums = (static_cast<uint8>(Genes.MovementType) & EnumMask) | ((static_cast<uint8>(Genes.AggressionLevel) & EnumMask) << EnumBits);
+	Packed.StepSize = QuantizeStepSize(Genes.MutationStepSize);
+
+	// Linear, no sRGB curve, so ReinterpretAsLinear restores the value
+	Packed.PrimaryColor = Genes.PrimaryColor.QuantizeRound();
+	Packed.SecondaryColor = Genes.SecondaryColor.QuantizeRound();
+	return Packed;
+}
+
+FCreatureGenes FPackedGenome::Unpack() const
+{
+	FCreatureGenes Genes;
+	for (int32 Trait = 0; Trait < FGeneTraits::Num; Trait++)
+	{
+		const EGeneTrait GeneTrait = static_cast<EGeneTrait>(Trait);
+		FGeneTraits::SetValue(Genes, GeneTrait, DequantizeTrait(GeneTrait, Traits[Trait]));
+	}
+
+	Genes.MovementType = GetMovementType();
+	Genes.AggressionLevel = GetAggressionLevel();
+	Genes.MutationStepSize = DequantizeStepSize(StepSize);
+	Genes.PrimaryColor = PrimaryColor.ReinterpretAsLinear();
+	Genes.SecondaryColor = SecondaryColor.ReinterpretAsLinear();
+	return Genes;
+}
+
+FArchive& operator<<(FArchive& Ar, FPackedGenome& Genome)
+{
+	for (uint16& Trait : Genome.Traits)
+	{
+		Ar << Trait;
+	}
+
+	Ar << Genome.Enums;
+	Ar << Genome.StepSize;
+	Ar << Genome.PrimaryColor;
+	Ar << Genome.SecondaryColor;
+	return Ar;
+}
+
+bool FPackedGenome::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << *this;
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
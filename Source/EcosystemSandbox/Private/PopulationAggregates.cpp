@@ -0,0 +1,243 @@
+#include "PopulationAggregates.h"
+
+void FPopulationAggregates::Reset()
+{
+	Creatures.Reset();
+	Base.Reset();
+	Rate.Reset();
+	bActive.Reset();
+	Versions.Reset();
+	MovementTypes.Reset();
+	AggressionLevels.Reset();
+	SlotLookup.Reset();
+
+	ActiveBaseSum = 0.0;
+	ActiveRateSum = 0.0;
+	ActivationHeap.Reset();
+
+	LeaderSlot = INDEX_NONE;
+	NextLeaderCheckTime = 0.0;
+	bLeaderDirty = true;
+
+	FMemory::Memzero(MovementTypeCounts);
+	FMemory::Memzero(AggressionLevelCounts);
+}
+
+void FPopulationAggregates::Add(ACreature* Creature, float Fitness, float FitnessRate, EMovementType MovementType, EAggressionLevel AggressionLevel, double Now)
+{
+	if (!Creature || SlotLookup.Contains(Creature))
+	{
+		return;
+	}
+
+	const int32 Slot = Creatures.Add(Creature);
+	Base.Add(0.0);
+	Rate.Add(FMath::Max(0.0f, FitnessRate));
+	bActive.Add(false);
+	Versions.Add(0);
+	MovementTypes.Add(static_cast<uint8>(MovementType));
+	AggressionLevels.Add(static_cast<uint8>(AggressionLevel));
+	SlotLookup.Add(Creature, Slot);
+
+	MovementTypeCounts[static_cast<int32>(MovementType)]++;
+	AggressionLevelCounts[static_cast<int32>(AggressionLevel)]++;
+
+	AnchorSlot(Slot, Fitness, Now);
+	ConsiderLeader(Slot, Now);
+}
+
+void FPopulationAggregates::Remove(const ACreature* Creature)
+{
+	int32 Slot = INDEX_NONE;
+	if (!SlotLookup.RemoveAndCopyValue(Creature, Slot))
+	{
+		return;
+	}
+
+	if (bActive[Slot])
+	{
+		Deactivate(Slot);
+	}
+
+	MovementTypeCounts[MovementTypes[Slot]]--;
+	AggressionLevelCounts[AggressionLevels[Slot]]--;
+
+	if (LeaderSlot == Slot)
+	{
+		LeaderSlot = INDEX_NONE;
+		bLeaderDirty = true;
+	}
+
+	// Swap the last slot into the hole
+	const int32 LastSlot = Creatures.Num() - 1;
+	if (Slot != LastSlot)
+	{
+		Creatures[Slot] = Creatures[LastSlot];
+		Base[Slot] = Base[LastSlot];
+		Rate[Slot] = Rate[LastSlot];
+		bActive[Slot] = bActive[LastSlot];
+		MovementTypes[Slot] = MovementTypes[LastSlot];
+		AggressionLevels[Slot] = AggressionLevels[LastSlot];
+		SlotLookup[Creatures[Slot]] = Slot;
+
+		// Pending activations refer to the old slot, requeue under the new one
+		Versions[Slot] = ++VersionCounter;
+		if (!bActive[Slot] && Rate[Slot] > 0.0)
+		{
+			ActivationHeap.HeapPush({ -Base[Slot] / Rate[Slot], Slot, Versions[Slot] });
+		}
+
+		if (LeaderSlot == LastSlot)
+		{
+			LeaderSlot = Slot;
+		}
+	}
+
+	Creatures.Pop(EAllowShrinking::No);
+	Base.Pop(EAllowShrinking::No);
+	Rate.Pop(EAllowShrinking::No);
+	bActive.Pop(EAllowShrinking::No);
+	Versions.Pop(EAllowShrinking::No);
+	MovementTypes.Pop(EAllowShrinking::No);
+	AggressionLevels.Pop(EAllowShrinking::No);
+}
+
+void FPopulationAggregates::UpdateFitness(const ACreature* Creature, float Fitness, double Now)
+{
+	if (const int32* Slot = SlotLookup.Find(Creature))
+	{
+		AnchorSlot(*Slot, Fitness, Now);
+		ConsiderLeader(*Slot, Now);
+	}
+}
+
+double FPopulationAggregates::GetTotalFitness(double Now)
+{
+	ProcessActivations(Now);
+	return ActiveBaseSum + ActiveRateSum * Now;
+}
+
+ACreature* FPopulationAggregates::FindLeader(double Now, float& OutFitness)
+{
+	OutFitness = 0.0f;
+
+	if (Creatures.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	if (bLeaderDirty || Now >= NextLeaderCheckTime)
+	{
+		RescanLeader(Now);
+	}
+
+	OutFitness = FMath::Max(0.0f, static_cast<float>(Evaluate(LeaderSlot, Now)));
+	return Creatures[LeaderSlot];
+}
+
+void FPopulationAggregates::Activate(int32 Slot)
+{
+	bActive[Slot] = true;
+	ActiveBaseSum += Base[Slot];
+	ActiveRateSum += Rate[Slot];
+}
+
+void FPopulationAggregates::Deactivate(int32 Slot)
+{
+	bActive[Slot] = false;
+	ActiveBaseSum -= Base[Slot];
+	ActiveRateSum -= Rate[Slot];
+}
+
+void FPopulationAggregates::ProcessActivations(double Now)
+{
+	while (ActivationHeap.Num() > 0 && ActivationHeap.HeapTop().Time <= Now)
+	{
+		FActivation Activation;
+		ActivationHeap.HeapPop(Activation, EAllowShrinking::No);
+
+		// Stale entries belong to re-anchored or moved slots
+		const int32 Slot = Activation.Slot;
+		if (Slot < Creatures.Num() && Versions[Slot] == Activation.Version && !bActive[Slot])
+		{
+			Activate(Slot);
+		}
+	}
+}
+
+void FPopulationAggregates::AnchorSlot(int32 Slot, float Fitness, double Now)
+{
+	if (bActive[Slot])
+	{
+		Deactivate(Slot);
+	}
+
+	Versions[Slot] = ++VersionCounter;
+	Base[Slot] = Fitness - Rate[Slot] * Now;
+
+	if (Fitness > 0.0f)
+	{
+		Activate(Slot);
+	}
+	else if (Rate[Slot] > 0.0)
+	{
+		// Joins the sums once aging lifts it above zero
+		ActivationHeap.HeapPush({ -Base[Slot] / Rate[Slot], Slot, Versions[Slot] });
+	}
+}
+
+void FPopulationAggregates::ConsiderLeader(int32 Slot, double Now)
+{
+	if (bLeaderDirty || Slot == LeaderSlot)
+	{
+		// A leader that gained fitness only pushes later overtakes further out
+		return;
+	}
+
+	if (LeaderSlot == INDEX_NONE)
+	{
+		bLeaderDirty = true;
+		return;
+	}
+
+	const double Lead = Evaluate(LeaderSlot, Now) - Evaluate(Slot, Now);
+	if (Lead < 0.0)
+	{
+		bLeaderDirty = true;
+	}
+	else if (Rate[Slot] > Rate[LeaderSlot])
+	{
+		NextLeaderCheckTime = FMath::Min(NextLeaderCheckTime, Now + Lead / (Rate[Slot] - Rate[LeaderSlot]));
+	}
+}
+
+void FPopulationAggregates::RescanLeader(double Now)
+{
+	LeaderRescanCount++;
+
+	LeaderSlot = 0;
+	double BestFitness = Evaluate(0, Now);
+	for (int32 Slot = 1; Slot < Creatures.Num(); Slot++)
+	{
+		const double SlotFitness = Evaluate(Slot, Now);
+		if (SlotFitness > BestFitness)
+		{
+			BestFitness = SlotFitness;
+			LeaderSlot = Slot;
+		}
+	}
+
+	// Earliest time a faster-aging creature can overtake the leader
+	NextLeaderCheckTime = TNumericLimits<double>::Max();
+	const double LeaderRate = Rate[LeaderSlot];
+	for (int32 Slot = 0; Slot < Creatures.Num(); Slot++)
+	{
+		if (Rate[Slot] > LeaderRate)
+		{
+			const double OvertakeTime = Now + (BestFitness - Evaluate(Slot, Now)) / (Rate[Slot] - LeaderRate);
+			NextLeaderCheckTime = FMath::Min(NextLeaderCheckTime, OvertakeTime);
+		}
+	}
+
+	bLeaderDirty = false;
+}
@@ -0,0 +1,269 @@
+#include "QuantileSketch.h"
+#include "SimulationRandom.h"
+
+namespace
+{
+	// Each level below the top holds this share of the one above
+	constexpr float CapacityDecay = 2.0f / 3.0f;
+
+	// Normalized ranks reported by FQuantileSummary
+	constexpr float SummaryFractions[] = { 0.0f, 0.1f, 0.25f, 0.5f, 0.75f, 0.9f, 1.0f };
+}
+
+FKllSketch::FKllSketch(int32 InK)
+	: K(FMath::Max(8, InK))
+{
+	AddLevel();
+}
+
+int32 FKllSketch::GetCapacity(int32 Level) const
+{
+	// The top level holds K values, lower levels shrink geometrically
+	const int32 Depth = Levels.Num() - Level - 1;
+	return FMath::CeilToInt32(FMath::Pow(CapacityDecay, static_cast<float>(Depth)) * K) + 1;
+}
+
+void FKllSketch::AddLevel()
+{
+	Levels.AddDefaulted();
+
+	MaxSize = 0;
+	for (int32 Level = 0; Level < Levels.Num(); Level++)
+	{
+		MaxSize += GetCapacity(Level);
+	}
+}
+
+void FKllSketch::Add(float Value)
+{
+	Min = Count == 0 ? Value : FMath::Min(Min, Value);
+	Max = Count == 0 ? Value : FMath::Max(Max, Value);
+	Count++;
+
+	Levels[0].Add(Value);
+	Size++;
+
+	if (Size >= MaxSize)
+	{
+		Compress();
+	}
+}
+
+void FKllSketch::Compress()
+{
+	// Compacts the lowest full level only, that frees enough room for the next additions
+	for (int32 Level = 0; Level < Levels.Num(); Level++)
+	{
+		if (Levels[Level].Num() < GetCapacity(Level))
+		{
+			continue;
+		}
+
+		if (Level + 1 == Levels.Num())
+		{
+			AddLevel();
+		}
+
+		TArray<float>& Source = Levels[Level];
+		TArray<float>& Target = Levels[Level + 1];
+		Source.Sort();
+
+		// An odd value out stays behind, every other value of the rest moves up at double weight
+		const int32 Kept = Source.Num() % 2;
+		const int32 Offset = Kept + static_cast<int32>(FSimulationRandomStream::Mix(CompactionCounter++) & 1);
+		for (int32 i = Offset; i < Source.Num(); i += 2)
+		{
+			Target.Add(Source[i]);
+		}
+
+		Size -= (Source.Num() - Kept) / 2;
+		Source.SetNum(Kept, EAllowShrinking::No);
+		return;
+	}
+}
+
+void FKllSketch::Merge(const FKllSketch& Other)
+{
+	if (Other.Count == 0)
+	{
+		return;
+	}
+
+	while (Levels.Num() < Other.Levels.Num())
+	{
+		AddLevel();
+	}
+
+	for (int32 Level = 0; Level < Other.Levels.Num(); Level++)
+	{
+		Levels[Level].Append(Other.Levels[Level]);
+		Size += Other.Levels[Level].Num();
+	}
+
+	Min = Count == 0 ? Other.Min : FMath::Min(Min, Other.Min);
+	Max = Count == 0 ? Other.Max : FMath::Max(Max, Other.Max);
+	Count += Other.Count;
+
+	while (Size >= MaxSize)
+	{
+		Compress();
+	}
+}
+
+void FKllSketch::Reset()
+{
+	Levels.Reset();
+	Size = 0;
+	Count = 0;
+	Min = 0.0f;
+	Max = 0.0f;
+	CompactionCounter = 0;
+	AddLevel();
+}
+
+void FKllSketch::GetQuantiles(TConstArrayView<float> Fractions, TArrayView<float> OutValues) const
+{
+	check(Fractions.Num() == OutValues.Num());
+
+	if (Count == 0)
+	{
+		for (float& Value : OutValues)
+		{
+			Value = 0.0f;
+		}
+		return;
+	}
+
+	// Every held value stands for 2^Level added values
+	TArray<TPair<float, int64>> Weighted;
+	Weighted.Reserve(Size);
+	for (int32 Level = 0; Level < Levels.Num(); Level++)
+	{
+		for (float Value : Levels[Level])
+		{
+			Weighted.Emplace(Value, 1ll << Level);
+		}
+	}
+
+	Weighted.Sort([](const TPair<float, int64>& A, const TPair<float, int64>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	int32 Index = 0;
+	int64 Cumulative = 0;
+	for (int32 i = 0; i < Fractions.Num(); i++)
+	{
+		const double Target = static_cast<double>(Fractions[i]) * Count;
+
+		// Exact ends
+		if (Fractions[i] <= 0.0f)
+		{
+			OutValues[i] = Min;
+			continue;
+		}
+		if (Fractions[i] >= 1.0f)
+		{
+			OutValues[i] = Max;
+			continue;
+		}
+
+		while (Index < Weighted.Num() - 1 && Cumulative + Weighted[Index].Value < Target)
+		{
+			Cumulative += Weighted[Index].Value;
+			Index++;
+		}
+		OutValues[i] = Weighted[Index].Key;
+	}
+}
+
+float FKllSketch::GetQuantile(float Fraction) const
+{
+	float Value = 0.0f;
+	GetQuantiles(MakeArrayView(&Fraction, 1), MakeArrayView(&Value, 1));
+	return Value;
+}
+
+float FKllSketch::GetRank(float Value) const
+{
+	if (Count == 0)
+	{
+		return 0.0f;
+	}
+
+	int64 Below = 0;
+	for (int32 Level = 0; Level < Levels.Num(); Level++)
+	{
+		for (float Held : Levels[Level])
+		{
+			Below += Held <= Value ? 1ll << Level : 0;
+		}
+	}
+	return static_cast<float>(static_cast<double>(Below) / Count);
+}
+
+FQuantileSummary FKllSketch::GetSummary() const
+{
+	float Values[UE_ARRAY_COUNT(SummaryFractions)];
+	GetQuantiles(SummaryFractions, Values);
+
+	FQuantileSummary Summary;
+	Summary.Count = static_cast<int32>(FMath::Min<int64>(Count, MAX_int32));
+	Summary.Min = Values[0];
+	Summary.P10 = Values[1];
+	Summary.P25 = Values[2];
+	Summary.Median = Values[3];
+	Summary.P75 = Values[4];
+	Summary.P90 = Values[5];
+	Summary.Max = Values[6];
+	return Summary;
+}
+
+void FPopulationSketch::Add(const FCreatureGenes& Genes, float CreatureFitness)
+{
+	Fitness.Add(CreatureFitness);
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		Traits[TraitIndex].Add(Genes.*FGeneTraits::Table[TraitIndex].Member);
+	});
+}
+
+void FPopulationSketch::Add(const FGenePool& Pool, int32 Row, float CreatureFitness)
+{
+	Fitness.Add(CreatureFitness);
+	for (int32 Trait = 0; Trait < FGeneTraits::Num; Trait++)
+	{
+		Traits[Trait].Add(Pool.Traits[Trait][Row]);
+	}
+}
+
+void FPopulationSketch::Merge(const FPopulationSketch& Other)
+{
+	Fitness.Merge(Other.Fitness);
+	for (int32 Trait = 0; Trait < FGeneTraits::Num; Trait++)
+	{
+		Traits[Trait].Merge(Other.Traits[Trait]);
+	}
+}
+
+void FPopulationSketch::Reset()
+{
+	Fitness.Reset();
+	for (FKllSketch& Trait : Traits)
+	{
+		Trait.Reset();
+	}
+}
+
+FGenerationQuantiles FPopulationSketch::GetQuantiles(int32 Generation) const
+{
+	FGenerationQuantiles Quantiles;
+	Quantiles.Generation = Generation;
+	Quantiles.Fitness = Fitness.GetSummary();
+	for (const FKllSketch& Trait : Traits)
+	{
+		Quantiles.Traits.Add(Trait.GetSummary());
+	}
+	return Quantiles;
+}
@@ -0,0 +1,288 @@
+#include "Speciation.h"
+#include "SimulationRandom.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	constexpr int32 NumTraits = FGenePool::NumTraits;
+
+	// Squared distance of Count rows from First to one centroid, a trait column at a time
+	FORCEINLINE void BlockDistances(const float* Columns, int32 NumRows, const float* Centroid, int32 First, int32 Count, float* RESTRICT OutDistances)
+	{
+		for (int32 i = 0; i < Count; i++)
+		{
+			OutDistances[i] = 0.0f;
+		}
+
+		for (int32 Trait = 0; Trait < NumTraits; Trait++)
+		{
+			const float* RESTRICT Column = Columns + Trait * NumRows + First;
+			const float Center = Centroid[Trait];
+			for (int32 i = 0; i < Count; i++)
+			{
+				const float Delta = Column[i] - Center;
+				OutDistances[i] += Delta * Delta;
+			}
+		}
+	}
+}
+
+FSpeciation::FSpeciation(const FSpeciationParams& InParams)
+	: Params(InParams)
+{
+}
+
+void FSpeciation::Cluster(const FGenePool& Population)
+{
+	const int32 NumRows = Population.Num();
+	const int32 NumSpecies = FMath::Min(Params.NumSpecies, NumRows);
+
+	Species.Init(INDEX_NONE, NumRows);
+	Distances.SetNumUninitialized(NumRows);
+
+	if (NumSpecies <= 0)
+	{
+		Centroids.Reset();
+		return;
+	}
+
+	Columns.SetNumUninitialized(NumTraits * NumRows);
+	FGeneTraits::ForEach([&](auto Trait)
+	{
+		constexpr int32 TraitIndex = decltype(Trait)::Value;
+		constexpr FGeneTraitDescriptor Descriptor = FGeneTraits::Table[TraitIndex];
+
+		const float* Values = Population.Traits[TraitIndex].GetData();
+		float* Column = &Columns[TraitIndex * NumRows];
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			Column[Row] = Descriptor.Normalize(Values[Row]);
+		}
+	});
+
+	// Last generation's centroids are the starting point for this one
+	if (Centroids.Num() != NumSpecies * NumTraits)
+	{
+		SeedCentroids(NumRows, NumSpecies);
+	}
+
+	for (int32 Iteration = 0; Iteration < FMath::Max(1, Params.MaxIterations); Iteration++)
+	{
+		if (Assign(NumRows) == 0)
+		{
+			break;
+		}
+
+		UpdateCentroids(NumRows);
+	}
+}
+
+void FSpeciation::SeedCentroids(int32 NumRows, int32 NumSpecies)
+{
+	// k-means++, every further centroid is a row drawn by its squared distance to the nearest one so far
+	FSimulationRandomStream Stream(Params.Seed, 0, NumSeedings++, ERandomStreamPurpose::Speciation);
+	Centroids.SetNumUninitialized(NumSpecies * NumTraits);
+
+	auto CopyRow = [&](int32 Row, int32 Target)
+	{
+		for (int32 Trait = 0; Trait < NumTraits; Trait++)
+		{
+			Centroids[Target * NumTraits + Trait] = Columns[Trait * NumRows + Row];
+		}
+	};
+
+	CopyRow(Stream.RandRange(0, NumRows - 1), 0);
+	BlockDistances(Columns.GetData(), NumRows, &Centroids[0], 0, NumRows, Distances.GetData());
+
+	TArray<float> NewDistances;
+	NewDistances.SetNumUninitialized(NumRows);
+
+	for (int32 Target = 1; Target < NumSpecies; Target++)
+	{
+		double Total = 0.0;
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			Total += Distances[Row];
+		}
+
+		// Falls back to a uniform draw once every row sits on a centroid
+		int32 Chosen = Stream.RandRange(0, NumRows - 1);
+		if (Total > 0.0)
+		{
+			double Remaining = Stream.GetFraction() * Total;
+			for (int32 Row = 0; Row < NumRows; Row++)
+			{
+				Remaining -= Distances[Row];
+				if (Remaining < 0.0 && Distances[Row] > 0.0f)
+				{
+					Chosen = Row;
+					break;
+				}
+			}
+		}
+
+		CopyRow(Chosen, Target);
+		BlockDistances(Columns.GetData(), NumRows, &Centroids[Target * NumTraits], 0, NumRows, NewDistances.GetData());
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			Distances[Row] = FMath::Min(Distances[Row], NewDistances[Row]);
+		}
+	}
+}
+
+int32 FSpeciation::Assign(int32 NumRows)
+{
+	const int32 NumSpecies = GetNumSpecies();
+	const int32 NumBlocks = FMath::DivideAndRoundUp(NumRows, BlockSize);
+
+	TArray<int32> BlockChanges;
+	BlockChanges.SetNumZeroed(NumBlocks);
+
+	ParallelFor(NumBlocks, [&](int32 Block)
+	{
+		const int32 First = Block * BlockSize;
+		const int32 Count = FMath::Min(BlockSize, NumRows - First);
+
+		float Best[BlockSize];
+		float Distance[BlockSize];
+		int32 Nearest[BlockSize];
+		for (int32 i = 0; i < Count; i++)
+		{
+			Best[i] = MAX_flt;
+			Nearest[i] = 0;
+		}
+
+		for (int32 Center = 0; Center < NumSpecies; Center++)
+		{
+			BlockDistances(Columns.GetData(), NumRows, &Centroids[Center * NumTraits], First, Count, Distance);
+
+			// Branchless so it vectorizes with the distances
+			for (int32 i = 0; i < Count; i++)
+			{
+				const bool bCloser = Distance[i] < Best[i];
+				Best[i] = bCloser ? Distance[i] : Best[i];
+				Nearest[i] = bCloser ? Center : Nearest[i];
+			}
+		}
+
+		int32 Changes = 0;
+		for (int32 i = 0; i < Count; i++)
+		{
+			Changes += Species[First + i] != Nearest[i] ? 1 : 0;
+			Species[First + i] = Nearest[i];
+			Distances[First + i] = Best[i];
+		}
+		BlockChanges[Block] = Changes;
+	});
+
+	int32 Changes = 0;
+	for (int32 BlockChange : BlockChanges)
+	{
+		Changes += BlockChange;
+	}
+	return Changes;
+}
+
+void FSpeciation::UpdateCentroids(int32 NumRows)
+{
+	const int32 NumSpecies = GetNumSpecies();
+
+	TArray<double> Sums;
+	Sums.SetNumZeroed(NumSpecies * NumTraits);
+	TArray<int32> Counts;
+	Counts.SetNumZeroed(NumSpecies);
+
+	for (int32 Row = 0; Row < NumRows; Row++)
+	{
+		Counts[Species[Row]]++;
+	}
+
+	for (int32 Trait = 0; Trait < NumTraits; Trait++)
+	{
+		const float* Column = &Columns[Trait * NumRows];
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			Sums[Species[Row] * NumTraits + Trait] += Column[Row];
+		}
+	}
+
+	for (int32 Center = 0; Center < NumSpecies; Center++)
+	{
+		if (Counts[Center] > 0)
+		{
+			for (int32 Trait = 0; Trait < NumTraits; Trait++)
+			{
+				Centroids[Center * NumTraits + Trait] = static_cast<float>(Sums[Center * NumTraits + Trait] / Counts[Center]);
+			}
+			continue;
+		}
+
+		// An empty species restarts at the row worst served by its own
+		int32 Farthest = 0;
+		for (int32 Row = 1; Row < NumRows; Row++)
+		{
+			Farthest = Distances[Row] > Distances[Farthest] ? Row : Farthest;
+		}
+
+		for (int32 Trait = 0; Trait < NumTraits; Trait++)
+		{
+			Centroids[Center * NumTraits + Trait] = Columns[Trait * NumRows + Farthest];
+		}
+		Distances[Farthest] = 0.0f;
+	}
+}
+
+void FSpeciation::ClusterAndShare(const FGenePool& Population, TArray<float>& InOutFitness)
+{
+	check(Population.Num() == InOutFitness.Num());
+
+	Cluster(Population);
+	const int32 NumSpecies = GetNumSpecies();
+
+	Stats.Reset();
+	if (NumSpecies == 0)
+	{
+		return;
+	}
+
+	Stats.SetNum(NumSpecies);
+	TArray<double> TotalFitness;
+	TotalFitness.SetNumZeroed(NumSpecies);
+
+	for (int32 Row = 0; Row < Population.Num(); Row++)
+	{
+		FSpeciesStats& SpeciesStats = Stats[Species[Row]];
+		SpeciesStats.MaxFitness = SpeciesStats.Size == 0 ? InOutFitness[Row] : FMath::Max(SpeciesStats.MaxFitness, InOutFitness[Row]);
+		SpeciesStats.Size++;
+		TotalFitness[Species[Row]] += InOutFitness[Row];
+
+		if (Population.Lineages[0][Row] != FLineageArena::InvalidId)
+		{
+			SpeciesStats.Members.Add(static_cast<int32>(Population.Lineages[0][Row]));
+		}
+	}
+
+	for (int32 Center = 0; Center < NumSpecies; Center++)
+	{
+		Stats[Center].Species = Center;
+		Stats[Center].AverageFitness = Stats[Center].Size > 0 ? static_cast<float>(TotalFitness[Center] / Stats[Center].Size) : 0.0f;
+	}
+
+	// Members of a species split its fitness, so a crowded niche stops outbreeding small ones
+	if (Params.bFitnessSharing)
+	{
+		for (int32 Row = 0; Row < Population.Num(); Row++)
+		{
+			InOutFitness[Row] /= Stats[Species[Row]].Size;
+		}
+	}
+}
+
+void FSpeciation::Reset()
+{
+	Columns.Reset();
+	Centroids.Reset();
+	Species.Reset();
+	Distances.Reset();
+	Stats.Reset();
+}
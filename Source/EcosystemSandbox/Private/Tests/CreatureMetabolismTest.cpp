@@ -0,0 +1,318 @@
+#include "CreatureMetabolism.h"
+#include "SimulationRandom.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Random creatures, then rows sitting on the thresholds of the health rules and the clamps
+	void FillMetabolismColumns(FCreatureLifeColumns& Columns, int32 NumRandom)
+	{
+		FSimulationRandomStream Stream(0, 0, 0, ERandomStreamPurpose::Creature);
+
+		for (int32 i = 0; i < NumRandom; i++)
+		{
+			FCreatureLifeState State;
+			State.Energy = Stream.FRandRange(0.0f, 100.0f);
+			State.Hunger = Stream.FRandRange(0.0f, 100.0f);
+			State.Age = Stream.FRandRange(0.0f, 50.0f);
+			State.Health = Stream.FRandRange(0.0f, 100.0f);
+			State.ReproductionCooldown = Stream.FRandRange(-1.0f, 20.0f);
+			Columns.Add(State, FCreatureMetabolism::DeriveRates(FCreatureGenes::GenerateRandom(Stream)));
+		}
+
+		const float Energies[] = { 0.0f, 0.01f, 50.0f, 70.0f, 70.01f, 100.0f };
+		const float Hungers[] = { 0.0f, 29.99f, 30.0f, 89.99f, 90.0f, 100.0f };
+		const float Healths[] = { 0.0f, 99.99f, 100.0f };
+		const float Cooldowns[] = { -1.0f, 0.0f, 0.001f, 5.0f };
+
+		for (const float Energy : Energies)
+		{
+			for (const float Hunger : Hungers)
+			{
+				for (int32 i = 0; i < UE_ARRAY_COUNT(Healths); i++)
+				{
+					FCreatureLifeState State;
+					State.Energy = Energy;
+					State.Hunger = Hunger;
+					State.Age = 10.0f;
+					State.Health = Healths[i];
+					State.ReproductionCooldown = Cooldowns[(Columns.Num() + i) % UE_ARRAY_COUNT(Cooldowns)];
+					Columns.Add(State, FCreatureMetabolism::DeriveRates(FCreatureGenes::GenerateRandom(Stream)));
+				}
+			}
+		}
+	}
+
+	// One unit in the last place at the value's magnitude, but never below that of 1.0. The ISPC compiler may fuse
+	// a multiply and subtract that the scalar loop rounds twice, which near a clamp to zero is larger than the result's own ulp.
+	float OneUlp(float Value)
+	{
+		const float Magnitude = FMath::Max(FMath::Abs(Value), 1.0f);
+
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, &Magnitude, sizeof(Bits));
+		Bits &= 0x7F800000;
+
+		float PowerOfTwo;
+		FMemory::Memcpy(&PowerOfTwo, &Bits, sizeof(PowerOfTwo));
+		return PowerOfTwo * FLT_EPSILON;
+	}
+
+	bool TestColumnMatches(FAutomationTestBase& Test, const TCHAR* Field, const TArray<float>& Vector, const TArray<float>& Scalar)
+	{
+		for (int32 i = 0; i < Scalar.Num(); i++)
+		{
+			if (!Test.TestEqual(Field, Vector[i], Scalar[i], OneUlp(Scalar[i])))
+			{
+				Test.AddInfo(FString::Printf(TEXT("%s first differs in row %d: ISPC %.9g, scalar %.9g"), Field, i, Vector[i], Scalar[i]));
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool TestColumnsMatch(FAutomationTestBase& Test, const FCreatureLifeColumns& Vector, const FCreatureLifeColumns& Scalar)
+	{
+		return TestColumnMatches(Test, TEXT("Energy"), Vector.Energy, Scalar.Energy)
+			&& TestColumnMatches(Test, TEXT("Hunger"), Vector.Hunger, Scalar.Hunger)
+			&& TestColumnMatches(Test, TEXT("Age"), Vector.Age, Scalar.Age)
+			&& TestColumnMatches(Test, TEXT("Health"), Vector.Health, Scalar.Health)
+			&& TestColumnMatches(Test, TEXT("ReproductionCooldown"), Vector.ReproductionCooldown, Scalar.ReproductionCooldown);
+	}
+
+	// StepLifeStats followed by ApplyWeather in double precision, so rounding over thousands of small steps does not
+	// hide the closed form's own error. Returns the time of the first step after which the creature is dead, or Interval.
+	float StepReference(FCreatureLifeState& State, const FCreatureMetabolismRates& Rates, const FCreatureWeatherRates& Weather, float Interval, double DeltaTime)
+	{
+		double Energy = State.Energy;
+		double Hunger = State.Hunger;
+		double Age = State.Age;
+		double Health = State.Health;
+		double Cooldown = State.ReproductionCooldown;
+		const double HungerGrowthRate = static_cast<double>(Rates.HungerGrowthRate) / Rates.HungerResistance;
+
+		const int32 NumSteps = FMath::RoundToInt32(Interval / DeltaTime);
+		int32 Step = 0;
+		for (; Step < NumSteps && Health > 0.0 && Age < Rates.LifeSpan; Step++)
+		{
+			Age += Rates.AgingRate * DeltaTime;
+			Energy = FMath::Max(0.0, Energy - Rates.EnergyDecayRate * DeltaTime);
+			Hunger = FMath::Min(100.0, Hunger + HungerGrowthRate * DeltaTime);
+			Cooldown = Cooldown > 0.0 ? Cooldown - DeltaTime : Cooldown;
+
+			if (Energy <= 0.0 || Hunger >= 90.0)
+			{
+				Health -= 10.0 * DeltaTime;
+			}
+			else if (Energy > 70.0 && Hunger < 30.0)
+			{
+				Health = FMath::Min(100.0, Health + 5.0 * DeltaTime);
+			}
+
+			Energy = FMath::Max(0.0, Energy - Weather.EnergyDecayRate * DeltaTime);
+			if (Energy > 70.0 && Hunger < 30.0)
+			{
+				Health = FMath::Min(100.0, Health + Weather.HealingRate * DeltaTime);
+			}
+		}
+
+		State.Energy = static_cast<float>(Energy);
+		State.Hunger = static_cast<float>(Hunger);
+		State.Age = static_cast<float>(Age);
+		State.Health = static_cast<float>(Health);
+		State.ReproductionCooldown = static_cast<float>(Cooldown);
+		return static_cast<float>(Step * DeltaTime);
+	}
+
+	// Compares AdvanceLifeStats with 1 ms stepping. Stepping notices a threshold or death up to a step late, so each
+	// field may be off by a few steps of its own rate, and the death time by a few steps.
+	void TestCatchUpMatchesStepping(FAutomationTestBase& Test, const FString& What, const FCreatureLifeState& Start, const FCreatureMetabolismRates& Rates,
+		const FCreatureWeatherRates& Weather, float Interval, FCreatureLifeState& OutAdvanced, float& OutAdvancedTime)
+	{
+		constexpr double DeltaTime = 0.001;
+		constexpr float LateSteps = 3.0f;
+		constexpr float Rounding = 1e-3f;
+
+		FCreatureLifeState Stepped = Start;
+		const float SteppedTime = StepReference(Stepped, Rates, Weather, Interval, DeltaTime);
+
+		OutAdvanced = Start;
+		OutAdvancedTime = FCreatureMetabolism::AdvanceLifeStats(OutAdvanced, Rates, Interval, Weather);
+
+		const float StepTolerance = LateSteps * static_cast<float>(DeltaTime);
+		const float HealthRate = 5.0f + Weather.HealingRate + 10.0f;
+
+		Test.TestEqual(*(What + TEXT(" time until death or end")), OutAdvancedTime, SteppedTime, StepTolerance);
+		Test.TestEqual(*(What + TEXT(" energy")), OutAdvanced.Energy, Stepped.Energy, (Rates.EnergyDecayRate + Weather.EnergyDecayRate) * StepTolerance + Rounding);
+		Test.TestEqual(*(What + TEXT(" hunger")), OutAdvanced.Hunger, Stepped.Hunger, Rates.HungerGrowthRate / Rates.HungerResistance * StepTolerance + Rounding);
+		Test.TestEqual(*(What + TEXT(" age")), OutAdvanced.Age, Stepped.Age, Rates.AgingRate * StepTolerance + Rounding);
+		Test.TestEqual(*(What + TEXT(" health")), OutAdvanced.Health, Stepped.Health, HealthRate * StepTolerance + Rounding);
+
+		// Stepping overshoots zero by up to a step, the closed form stops at it
+		Test.TestEqual(*(What + TEXT(" reproduction cooldown")), FMath::Max(0.0f, OutAdvanced.ReproductionCooldown), FMath::Max(0.0f, Stepped.ReproductionCooldown), StepTolerance + Rounding);
+		Test.TestTrue(*(What + TEXT(" dead only when stopped early")), FCreatureMetabolism::IsDead(OutAdvanced, Rates) == (OutAdvancedTime < Interval));
+	}
+
+	FCreatureMetabolismRates MakeRates(float EnergyDecayRate, float HungerGrowthRate, float AgingRate, float LifeSpan)
+	{
+		FCreatureMetabolismRates Rates;
+		Rates.EnergyDecayRate = EnergyDecayRate;
+		Rates.HungerGrowthRate = HungerGrowthRate;
+		Rates.HungerResistance = 1.0f;
+		Rates.AgingRate = AgingRate;
+		Rates.LifeSpan = LifeSpan;
+		return Rates;
+	}
+
+	FCreatureLifeState MakeState(float Energy, float Hunger, float Age, float Health, float ReproductionCooldown = 0.0f)
+	{
+		FCreatureLifeState State;
+		State.Energy = Energy;
+		State.Hunger = Hunger;
+		State.Age = Age;
+		State.Health = Health;
+		State.ReproductionCooldown = ReproductionCooldown;
+		return State;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCreatureMetabolismISPCMatchesScalarTest, "EcosystemSandbox.Metabolism.ISPCMatchesScalar",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCreatureMetabolismISPCMatchesScalarTest::RunTest(const FString& Parameters)
+{
+	if (!FCreatureMetabolism::HasISPCKernels())
+	{
+		AddInfo(TEXT("Metabolism ISPC kernels are not compiled for this platform"));
+		return true;
+	}
+
+	constexpr int32 NumSteps = 120;
+	constexpr float DeltaTime = 1.0f / 60.0f;
+
+	// Cold fog and mild clear weather alternate so every weather term is exercised
+	const FVector2f Weathers[2] = { FVector2f(0.1f, 0.3f), FVector2f(0.5f, 1.0f) };
+
+	FCreatureLifeColumns Scalar;
+	FillMetabolismColumns(Scalar, 1024);
+
+	// Each step starts both paths from the same columns, so a last bit moved in one step cannot
+	// flip a threshold in a later one
+	for (int32 Step = 0; Step < NumSteps; Step++)
+	{
+		FCreatureLifeColumns Vector = Scalar;
+
+		FCreatureMetabolism::StepLifeStats(Scalar, DeltaTime, false);
+		FCreatureMetabolism::StepLifeStats(Vector, DeltaTime, true);
+		if (!TestColumnsMatch(*this, Vector, Scalar))
+		{
+			AddError(FString::Printf(TEXT("StepLifeStats differs in step %d"), Step));
+			return false;
+		}
+
+		Vector = Scalar;
+		const FVector2f& Weather = Weathers[Step % 2];
+		FCreatureMetabolism::ApplyWeather(Scalar, Weather.X, Weather.Y, DeltaTime, false);
+		FCreatureMetabolism::ApplyWeather(Vector, Weather.X, Weather.Y, DeltaTime, true);
+		if (!TestColumnsMatch(*this, Vector, Scalar))
+		{
+			AddError(FString::Printf(TEXT("ApplyWeather differs in step %d"), Step));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCreatureMetabolismCatchUpSegmentsTest, "EcosystemSandbox.Metabolism.CatchUpSegments",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCreatureMetabolismCatchUpSegmentsTest::RunTest(const FString& Parameters)
+{
+	const FCreatureWeatherRates NoWeather;
+	constexpr float Exact = 1e-3f;
+	FCreatureLifeState Advanced;
+	float Time;
+
+	// Energy runs out at 10 s, then health falls at 10 per second
+	{
+		const FCreatureMetabolismRates Rates = MakeRates(2.0f, 1.0f, 1.0f, 100.0f);
+		TestCatchUpMatchesStepping(*this, TEXT("Starving partway"), MakeState(20.0f, 10.0f, 10.0f, 100.0f), Rates, NoWeather, 14.0f, Advanced, Time);
+		TestEqual(TEXT("Starving partway time"), Time, 14.0f, Exact);
+		TestEqual(TEXT("Starving partway energy"), Advanced.Energy, 0.0f, Exact);
+		TestEqual(TEXT("Starving partway hunger"), Advanced.Hunger, 24.0f, Exact);
+		TestEqual(TEXT("Starving partway health"), Advanced.Health, 60.0f, Exact);
+	}
+
+	// Thriving until energy falls to 70 at 10 s, neutral until it runs out at 45 s, then starving to death at 54 s
+	{
+		const FCreatureMetabolismRates Rates = MakeRates(2.0f, 1.0f, 1.0f, 100.0f);
+		const FCreatureLifeState Start = MakeState(90.0f, 0.0f, 0.0f, 40.0f);
+
+		TestCatchUpMatchesStepping(*this, TEXT("Thriving to starving"), Start, Rates, NoWeather, 50.0f, Advanced, Time);
+		TestEqual(TEXT("Thriving to starving time"), Time, 50.0f, Exact);
+		TestEqual(TEXT("Thriving to starving hunger"), Advanced.Hunger, 50.0f, Exact);
+		TestEqual(TEXT("Thriving to starving health"), Advanced.Health, 40.0f, Exact);
+
+		TestCatchUpMatchesStepping(*this, TEXT("Thriving to death"), Start, Rates, NoWeather, 60.0f, Advanced, Time);
+		TestEqual(TEXT("Thriving to death time"), Time, 54.0f, Exact);
+		TestTrue(TEXT("Thriving to death is dead"), FCreatureMetabolism::IsDead(Advanced, Rates));
+		TestEqual(TEXT("Thriving to death age"), Advanced.Age, 54.0f, Exact);
+	}
+
+	// Old age at 2.5 s while health is untouched
+	{
+		const FCreatureMetabolismRates Rates = MakeRates(1.0f, 1.0f, 2.0f, 100.0f);
+		TestCatchUpMatchesStepping(*this, TEXT("Death by age"), MakeState(50.0f, 50.0f, 95.0f, 80.0f), Rates, NoWeather, 10.0f, Advanced, Time);
+		TestEqual(TEXT("Death by age time"), Time, 2.5f, Exact);
+		TestTrue(TEXT("Death by age is dead"), FCreatureMetabolism::IsDead(Advanced, Rates));
+		TestEqual(TEXT("Death by age health"), Advanced.Health, 80.0f, Exact);
+		TestEqual(TEXT("Death by age energy"), Advanced.Energy, 47.5f, Exact);
+	}
+
+	// A cooldown that runs out during the interval ends at exactly zero, an expired one is left alone
+	{
+		const FCreatureMetabolismRates Rates = MakeRates(1.0f, 1.0f, 1.0f, 100.0f);
+		TestCatchUpMatchesStepping(*this, TEXT("Cooldown crossing zero"), MakeState(50.0f, 50.0f, 10.0f, 80.0f, 3.0f), Rates, NoWeather, 5.0f, Advanced, Time);
+		TestEqual(TEXT("Cooldown crossing zero"), Advanced.ReproductionCooldown, 0.0f);
+
+		TestCatchUpMatchesStepping(*this, TEXT("Expired cooldown"), MakeState(50.0f, 50.0f, 10.0f, 80.0f, -1.0f), Rates, NoWeather, 5.0f, Advanced, Time);
+		TestEqual(TEXT("Expired cooldown"), Advanced.ReproductionCooldown, -1.0f);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCreatureMetabolismCatchUpMatchesSteppingTest, "EcosystemSandbox.Metabolism.CatchUpMatchesStepping",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCreatureMetabolismCatchUpMatchesSteppingTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumCreatures = 256;
+	constexpr float Interval = 30.0f;
+
+	// Cold fog and mild clear weather, each held for the whole interval
+	const FCreatureWeatherRates Weathers[2] = { FCreatureMetabolism::GetWeatherRates(0.1f, 0.3f), FCreatureMetabolism::GetWeatherRates(0.5f, 1.0f) };
+
+	for (int32 WeatherIndex = 0; WeatherIndex < UE_ARRAY_COUNT(Weathers); WeatherIndex++)
+	{
+		FSimulationRandomStream Stream(0, WeatherIndex, 0, ERandomStreamPurpose::Creature);
+
+		for (int32 i = 0; i < NumCreatures; i++)
+		{
+			const FCreatureLifeState Start = MakeState(Stream.FRandRange(0.0f, 100.0f), Stream.FRandRange(0.0f, 100.0f), Stream.FRandRange(0.0f, 50.0f),
+				Stream.FRandRange(0.0f, 100.0f), Stream.FRandRange(-1.0f, 20.0f));
+			const FCreatureMetabolismRates Rates = FCreatureMetabolism::DeriveRates(FCreatureGenes::GenerateRandom(Stream));
+
+			FCreatureLifeState Advanced;
+			float Time;
+			TestCatchUpMatchesStepping(*this, FString::Printf(TEXT("Weather %d creature %d"), WeatherIndex, i), Start, Rates, Weathers[WeatherIndex], Interval, Advanced, Time);
+		}
+	}
+
+	return true;
+}
+
+#endif
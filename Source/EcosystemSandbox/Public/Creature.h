@@ -6,10 +6,15 @@
 #include "Components/SphereComponent.h"
 #include "Engine/Engine.h"
 #include "CreatureGenetics.h"
+#include "CreatureLifeState.h"
+#include "CreatureMetabolism.h"
+#include "GenomeFitnessCache.h"
+#include "LineageArena.h"
 #include "Creature.generated.h"
 
 class ACreatureAIController;
-class ADynamicWeatherSystem;
+class UCreatureSimulationSubsystem;
+class UCreatureSignificanceSubsystem;
 
 UENUM(BlueprintType)
 enum class ECreatureState : uint8
@@ -26,6 +31,7 @@ enum class ECreatureState : uint8
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCreatureDeath, ACreature*, DeadCreature, float, FitnessScore);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnCreatureReproduction, ACreature*, Parent1, ACreature*, Parent2, FCreatureGenes, OffspringGenes);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCreatureFitnessChanged, ACreature*);
 
 UCLASS()
 class ECOSYSTEMSANDBOX_API ACreature : public ACharacter
@@ -37,7 +43,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// Components
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
@@ -50,7 +56,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetics")
 	FCreatureGenes Genes;
 
-	// Life Stats
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Genetics")
+	int32 CreatureId = INDEX_NONE;
+
+	// Life Stats, stepped by UCreatureSimulationSubsystem and copied back here on transitions and when the creature stops being simulated
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Life Stats")
 	float Energy = 100.0f;
 
@@ -81,7 +90,7 @@ protected:
 	int32 CombatWins = 0;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat")
-	float LastAttackTime = 0.0f;
+	double LastAttackTime = 0.0;
 
 	// Resources
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Resources")
@@ -97,16 +106,16 @@ protected:
 public:
 	// Getters
 	UFUNCTION(BlueprintCallable, Category = "Creature")
-	float GetEnergy() const { return Energy; }
+	float GetEnergy() const { return GetLifeState().Energy; }
 
 	UFUNCTION(BlueprintCallable, Category = "Creature")
-	float GetHunger() const { return Hunger; }
+	float GetHunger() const { return GetLifeState().Hunger; }
 
 	UFUNCTION(BlueprintCallable, Category = "Creature")
-	float GetAge() const { return Age; }
+	float GetAge() const { return GetLifeState().Age; }
 
 	UFUNCTION(BlueprintCallable, Category = "Creature")
-	float GetHealth() const { return Health; }
+	float GetHealth() const { return GetLifeState().Health; }
 
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	ECreatureState GetCurrentState() const { return CurrentState; }
@@ -114,12 +123,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	FCreatureGenes GetGenes() const { return Genes; }
 
+	UFUNCTION(BlueprintCallable, Category = "Creature")
+	int32 GetCreatureId() const { return CreatureId; }
+
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	bool CanReproduce() const;
 
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	float CalculateFitnessScore() const;
 
+	// Fitness before clamping at zero
+	float CalculateRawFitnessScore() const;
+
+	// Fitness gained per second of aging
+	float GetFitnessRate() const;
+
+	// Fired when offspring, combat wins or gathered resources change the fitness score
+	FOnCreatureFitnessChanged OnFitnessChanged;
+
 	// Actions
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	void SetCreatureState(ECreatureState NewState);
@@ -127,6 +148,21 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	void InitializeWithGenes(const FCreatureGenes& NewGenes);
 
+	// Same as InitializeWithGenes with an evaluation that was already computed, e.g. by FGenomeFitnessCache
+	void InitializeWithEvaluatedGenes(const FCreatureGenes& NewGenes, const FGenomeEvaluation& NewEvaluation);
+
+	// Assigns the id and the random stream used for this creature's offspring
+	void InitializeRandomStream(int32 NewCreatureId, const FSimulationRandomStream& NewStream);
+	const FSimulationRandomStream& GetRandomStream() const { return RandomStream; }
+
+	// Record of this creature in the manager's FLineageArena
+	void SetLineageId(uint32 NewLineageId) { LineageId = NewLineageId; }
+	uint32 GetLineageId() const { return LineageId; }
+
+	// Life stats as plain data, read through the simulation while the creature is registered with it
+	FCreatureLifeState GetLifeState() const;
+	void RestoreLifeState(const FCreatureLifeState& State);
+
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	bool AttemptReproduction(ACreature* Mate);
 
@@ -142,23 +178,73 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Creature")
 	void Die();
 
+	// Pooling, see UCreaturePoolSubsystem
+	void DeactivateForPool();
+	void ResetForReuse(const FTransform& Transform);
+	bool IsPooled() const { return bPooled; }
+
+	// Weather scaling of the gene-driven walk speed
+	void SetMovementModifier(float Modifier);
+
+	// World time of the last overlap, fight, meal or mating, used by UCreatureSignificanceSubsystem
+	float GetLastInteractionTime() const { return LastInteractionTime; }
+
 protected:
 	// Internal functions
-	void UpdateLifeStats(float DeltaTime);
+	void SetLifeState(const FCreatureLifeState& State);
 	void UpdateAppearance();
 	void UpdateMovementParameters();
 	void ApplyGeneticTraits();
-	void UpdateWeatherEffects(float DeltaTime);
+	void ReturnToPool();
+
+	// Registers with UCreatureSimulationSubsystem, or passes it new rates when already registered
+	void StartSimulation();
+
+	// Called by the simulation when energy, hunger or reproduction readiness changed enough for the AI
+	void NotifyLifeStatsChanged(bool bCanReproduce);
+
+	// Registers with UCreatureSignificanceSubsystem once the creature is active in the world
+	void StartSignificance();
+
+	// Tick interval of this creature, its controller and their components, set from the significance tier
+	void SetTickInterval(float TickInterval);
+
+	// Low significance creatures hibernate in UCreatureSimulationSubsystem
+	void SetHibernating(bool bHibernate);
+
+	void NoteInteraction();
 
 	UFUNCTION()
 	void OnInteractionSphereBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
 private:
+	friend class UCreatureSimulationSubsystem;
+	friend class UCreatureSignificanceSubsystem;
+
 	ACreatureAIController* CreatureAI;
-	ADynamicWeatherSystem* WeatherSystem;
+	FSimulationRandomStream RandomStream;
+	uint32 LineageId = FLineageArena::InvalidId;
+
+	// Reused across pooled lives instead of creating a new one per appearance update
+	UPROPERTY()
+	class UMaterialInstanceDynamic* BodyMaterial = nullptr;
+
+	FTimerHandle PoolReleaseTimer;
+	bool bPooled = false;
 	
-	// Cached values for performance
-	float EnergyDecayRate = 1.0f;
-	float HungerGrowthRate = 1.5f;
-	float AgingRate = 1.0f;
+	// Genes-only fitness terms and metabolism rates, evaluated once per genome
+	FGenomeEvaluation Evaluation;
+
+	// Set while UCreatureSimulationSubsystem owns the stepped life stats, the slot is among the sleepers while hibernating
+	UCreatureSimulationSubsystem* Simulation = nullptr;
+	int32 SimulationSlot = INDEX_NONE;
+	bool bHibernating = false;
+
+	float MovementModifier = 1.0f;
+
+	// Set while UCreatureSignificanceSubsystem picks the tick rate
+	UCreatureSignificanceSubsystem* Significance = nullptr;
+	int32 SignificanceSlot = INDEX_NONE;
+
+	float LastInteractionTime = TNumericLimits<float>::Lowest();
 };
@@ -19,7 +19,6 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI")
 	class UBehaviorTreeComponent* BehaviorTreeComponent;
@@ -63,9 +62,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void UpdateCreatureState(const FString& NewState);
 
+	// Pushed by UCreatureSimulationSubsystem when the stats moved enough to matter
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void UpdateStats(float Energy, float Hunger, bool bCanReproduce);
 
+	// Set by the controlled creature from its significance tier
+	void SetTickInterval(float TickInterval);
+
+	// Pooling, called by the controlled creature
+	void DeactivateForPool();
+	void ResetForReuse();
+
 protected:
 	UFUNCTION()
 	void OnPerceptionUpdated(const TArray<AActor*>& UpdatedActors);
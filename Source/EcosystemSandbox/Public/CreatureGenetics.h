@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Engine/DataTable.h"
+#include "SimulationRandom.h"
 #include "CreatureGenetics.generated.h"
 
 UENUM(BlueprintType)
@@ -12,7 +13,8 @@ enum class EMovementType : uint8
 	Flyer		UMETA(DisplayName = "Flyer"),
 	Swimmer		UMETA(DisplayName = "Swimmer"),
 	Crawler		UMETA(DisplayName = "Crawler"),
-	Jumper		UMETA(DisplayName = "Jumper")
+	Jumper		UMETA(DisplayName = "Jumper"),
+	Count		UMETA(Hidden)
 };
 
 UENUM(BlueprintType)
@@ -22,7 +24,17 @@ enum class EAggressionLevel : uint8
 	Defensive	UMETA(DisplayName = "Defensive"),
 	Territorial	UMETA(DisplayName = "Territorial"),
 	Aggressive	UMETA(DisplayName = "Aggressive"),
-	Predatory	UMETA(DisplayName = "Predatory")
+	Predatory	UMETA(DisplayName = "Predatory"),
+	Count		UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EMutationMode : uint8
+{
+	// Each trait mutates with MutationRate by up to MutationStrength
+	Fixed			UMETA(DisplayName = "Fixed Strength"),
+	// Every trait moves by a Gaussian step scaled by the genome's own MutationStepSize, which evolves with it
+	SelfAdaptive	UMETA(DisplayName = "Self-Adaptive (Evolution Strategy)")
 };
 
 USTRUCT(BlueprintType)
@@ -80,20 +92,56 @@ struct ECOSYSTEMSANDBOX_API FCreatureGenes
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FLinearColor SecondaryColor = FLinearColor::Gray;
 
+	static constexpr float MinStepSize = 0.001f;
+	static constexpr float MaxStepSize = 0.5f;
+	static constexpr float DefaultStepSize = 0.1f;
+
+	// Strategy parameter of self-adaptive mutation: standard deviation of trait steps as a share of each
+	// trait's range. Inherited and mutated like a trait, but never expressed.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.001", ClampMax = "0.5"))
+	float MutationStepSize = DefaultStepSize;
+
 	FCreatureGenes()
 	{
 		// Default constructor
 	}
 
 	// Mutation function
-	void Mutate(float MutationRate = 0.1f, float MutationStrength = 0.2f);
+	void Mutate(FSimulationRandomStream& Stream, float MutationRate = 0.1f, float MutationStrength = 0.2f);
+
+	// Log-normal update of MutationStepSize, then a Gaussian step on every continuous trait.
+	// Enums and colors are rerolled with MutationRate as in Mutate.
+	void MutateSelfAdaptive(FSimulationRandomStream& Stream, float MutationRate = 0.1f);
+
+	// Learning rate of the step size, 1 / sqrt(number of continuous traits)
+	static float GetStepSizeLearningRate();
 
 	// Crossover function for reproduction
-	static FCreatureGenes Crossover(const FCreatureGenes& Parent1, const FCreatureGenes& Parent2);
+	static FCreatureGenes Crossover(const FCreatureGenes& Parent1, const FCreatureGenes& Parent2, FSimulationRandomStream& Stream);
 
 	// Calculate fitness score
 	float CalculateFitness(float Age, int32 OffspringCount, float ResourcesGathered, int32 CombatWins) const;
 
+	// Fitness score before clamping at zero
+	float CalculateRawFitness(float Age, int32 OffspringCount, float ResourcesGathered, int32 CombatWins) const;
+
+	// Parts of the fitness score, genes-only terms can be memoized per genome, see FGenomeFitnessCache
+	float CalculateTraitFitness() const;
+	float GetSurvivalFitnessRate() const { return 100.0f / LifeSpan; }
+	static float CalculateAchievementFitness(int32 OffspringCount, float ResourcesGathered, int32 CombatWins);
+
 	// Generate random genes
-	static FCreatureGenes GenerateRandom();
+	static FCreatureGenes GenerateRandom(FSimulationRandomStream& Stream);
+
+	// Replicated as an FPackedGenome, 32 bytes with 16-bit traits and 8-bit colors
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FCreatureGenes> : public TStructOpsTypeTraitsBase2<FCreatureGenes>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
 };
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+#include "PackedGenome.h"
+#include "CreatureHistoryLog.generated.h"
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+USTRUCT(BlueprintType)
+struct ECOSYSTEMSANDBOX_API FCreatureRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FCreatureGenes Genes;
+
+	UPROPERTY()
+	float FitnessScore = 0.0f;
+
+	UPROPERTY()
+	float LifeTime = 0.0f;
+
+	UPROPERTY()
+	int32 Generation = 0;
+
+	UPROPERTY()
+	int32 OffspringCount = 0;
+};
+
+// On-disk layout of one record, fixed size so the log can be indexed in place.
+// Also the in-memory form of the recent history, half the size of an FCreatureRecord.
+struct FCreatureHistoryDiskRecord
+{
+	FPackedGenome Genome;
+	float FitnessScore;
+	float LifeTime;
+	int32 Generation;
+	int32 OffspringCount;
+
+	static FCreatureHistoryDiskRecord FromRecord(const FCreatureRecord& Record);
+	FCreatureRecord ToRecord() const;
+};
+
+static_assert(sizeof(FCreatureHistoryDiskRecord) == 48, "History log record layout changed, bump FCreatureHistoryLogHeader::CurrentVersion");
+
+struct FCreatureHistoryLogHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x48435345; // "ESCH"
+	static constexpr uint32 CurrentVersion = 3;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	uint32 RecordSize = sizeof(FCreatureHistoryDiskRecord);
+	uint32 Reserved = 0;
+};
+
+/**
+ * Death records of a run. The most recent records stay in a fixed-size ring buffer,
+ * every record is also appended to a binary log on disk in batches, so memory stays
+ * bounded however long the simulation runs. Use FCreatureHistoryLogReader to analyze the log.
+ */
+class ECOSYSTEMSANDBOX_API FCreatureHistoryLog
+{
+public:
+	~FCreatureHistoryLog();
+
+	// Starts a new log file, replacing any existing one at Path
+	bool Open(const FString& Path, int32 RingCapacity, int32 FlushBatchSize);
+	void Close();
+
+	void Add(const FCreatureRecord& Record);
+
+	// Writes pending records to disk
+	void Flush();
+
+	// Fills the in-memory ring without writing to disk, used when resuming from a snapshot
+	void Preload(TConstArrayView<FCreatureHistoryDiskRecord> Records);
+
+	// Up to Count most recent records, oldest first
+	TArray<FCreatureRecord> GetRecent(int32 Count) const;
+
+	// Records added since Open, in memory or on disk
+	int64 Num() const { return TotalRecords; }
+	int32 NumInMemory() const { return Ring.Num(); }
+
+	const FString& GetPath() const { return Path; }
+
+private:
+	FString Path;
+	TUniquePtr<IFileHandle> FileHandle;
+
+	// Packed, converted back to FCreatureRecord by GetRecent
+	TArray<FCreatureHistoryDiskRecord> Ring;
+	int32 RingCapacity = 0;
+	int32 RingHead = 0;
+
+	TArray<FCreatureHistoryDiskRecord> PendingWrites;
+	int32 FlushBatchSize = 256;
+	int64 TotalRecords = 0;
+};
+
+/**
+ * Read-only view of a history log. The file is memory mapped when the platform
+ * allows it and read in chunks otherwise, records never go through UObject memory.
+ */
+class ECOSYSTEMSANDBOX_API FCreatureHistoryLogReader
+{
+public:
+	~FCreatureHistoryLogReader();
+
+	bool Open(const FString& Path);
+	void Close();
+
+	int64 Num() const { return NumRecords; }
+
+	// Random access, only available when mapped
+	bool IsMapped() const { return MappedRegion.IsValid(); }
+	const FCreatureHistoryDiskRecord& GetDiskRecord(int64 Index) const;
+
+	// Visits every record in file order
+	void ForEach(TFunctionRef<void(const FCreatureRecord&)> Visitor) const;
+
+private:
+	FString Path;
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	const FCreatureHistoryDiskRecord* MappedRecords = nullptr;
+	int64 NumRecords = 0;
+};
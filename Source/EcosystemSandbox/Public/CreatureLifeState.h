@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Mutable life stats of one creature, plain data so it can be copied in bulk and written to disk as-is
+struct FCreatureLifeState
+{
+	float Energy = 100.0f;
+	float Hunger = 0.0f;
+	float Age = 0.0f;
+	float Health = 100.0f;
+	float ReproductionCooldown = 0.0f;
+	float ResourcesGathered = 0.0f;
+	int32 OffspringCount = 0;
+	int32 CombatWins = 0;
+};
+
+static_assert(sizeof(FCreatureLifeState) == 32, "Life state layout changed, bump FEcosystemSnapshotHeader::CurrentVersion");
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+#include "CreatureLifeState.h"
+
+// Per-second rates derived once from a creature's genes
+struct FCreatureMetabolismRates
+{
+	float EnergyDecayRate = 1.0f;
+	float HungerGrowthRate = 1.5f;
+	float HungerResistance = 1.0f;
+	float AgingRate = 1.0f;
+	float MaturityAge = 10.0f;
+	float LifeSpan = 30.0f;
+};
+
+// Weather effects as per-second rates, for integrating over an interval instead of stepping a frame
+struct FCreatureWeatherRates
+{
+	// Temperature stress and poor visibility together
+	float EnergyDecayRate = 0.0f;
+
+	// Extra healing while thriving in comfortable weather
+	float HealingRate = 0.0f;
+};
+
+// Life stats and rates of many creatures, one array per field, stepped together by FCreatureMetabolism::StepLifeStats.
+// Counters that only change on events, such as offspring and combat wins, are not included.
+struct ECOSYSTEMSANDBOX_API FCreatureLifeColumns
+{
+	TArray<float> Energy;
+	TArray<float> Hunger;
+	TArray<float> Age;
+	TArray<float> Health;
+	TArray<float> ReproductionCooldown;
+
+	TArray<float> EnergyDecayRate;
+
+	// Already divided by HungerResistance, so a step needs no division
+	TArray<float> HungerGrowthRate;
+	TArray<float> AgingRate;
+	TArray<float> MaturityAge;
+	TArray<float> LifeSpan;
+
+	int32 Num() const { return Energy.Num(); }
+
+	int32 Add(const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates);
+	void RemoveAtSwap(int32 Index);
+	void Reset();
+
+	// Only the stepped fields are read and written
+	void GetState(int32 Index, FCreatureLifeState& InOutState) const;
+	void SetState(int32 Index, const FCreatureLifeState& State);
+	void SetRates(int32 Index, const FCreatureMetabolismRates& Rates);
+
+	// Rates of the row, with HungerResistance folded into HungerGrowthRate
+	FCreatureMetabolismRates GetRates(int32 Index) const;
+
+	// Appends a copy of another row, returns its index
+	int32 AddFrom(const FCreatureLifeColumns& Other, int32 Index);
+
+	// FCreatureMetabolism::CanReproduce and IsDead of one row, inline so transition scans vectorize
+	FORCEINLINE bool CanReproduce(int32 Index) const
+	{
+		return (Age[Index] >= MaturityAge[Index]) & (Energy[Index] > 50.0f) & (Hunger[Index] < 70.0f) &
+			   (ReproductionCooldown[Index] <= 0.0f) & (Health[Index] > 30.0f);
+	}
+
+	FORCEINLINE bool IsDead(int32 Index) const
+	{
+		return (Health[Index] <= 0.0f) | (Age[Index] >= LifeSpan[Index]);
+	}
+};
+
+/**
+ * Life cycle rules of a creature as pure functions on plain data. UCreatureSimulationSubsystem
+ * runs them on the stats of every creature each frame and the headless simulation runs them on
+ * arrays, so both evolve creatures under exactly the same metabolism.
+ */
+struct ECOSYSTEMSANDBOX_API FCreatureMetabolism
+{
+	static FCreatureMetabolismRates DeriveRates(const FCreatureGenes& Genes);
+
+	// Aging, energy decay, hunger growth, cooldown and health effects over DeltaTime
+	static void StepLifeStats(FCreatureLifeState& State, const FCreatureMetabolismRates& Rates, float DeltaTime);
+
+	// Same rules over every creature of Columns. Runs the ISPC kernels when the platform has them and
+	// Ecosystem.Metabolism.ISPC is set, plain loops otherwise.
+	static void StepLifeStats(FCreatureLifeColumns& Columns, float DeltaTime);
+
+	// Temperature stress, poor visibility and comfortable-weather healing, the same weather for every creature
+	static void ApplyWeather(FCreatureLifeColumns& Columns, float TemperatureEffect, float VisibilityModifier, float DeltaTime);
+
+	// Whether the ISPC kernels are compiled for this platform
+	static bool HasISPCKernels();
+
+	// The batched steps through the ISPC kernels or the plain loops regardless of Ecosystem.Metabolism.ISPC, for
+	// comparing the two. bUseISPC is ignored without kernels.
+	static void StepLifeStats(FCreatureLifeColumns& Columns, float DeltaTime, bool bUseISPC);
+	static void ApplyWeather(FCreatureLifeColumns& Columns, float TemperatureEffect, float VisibilityModifier, float DeltaTime, bool bUseISPC);
+
+	static FCreatureWeatherRates GetWeatherRates(float TemperatureEffect, float VisibilityModifier);
+
+	// StepLifeStats and ApplyWeather over Interval as if stepped with an infinitely small DeltaTime. Energy only
+	// falls and hunger only rises, so health passes through at most a thriving, a neutral and a starving segment,
+	// each linear, and the segment boundaries are solved for directly. O(1) for any Interval. Stops at death and
+	// returns the time advanced, which is less than Interval when the creature died during it.
+	static float AdvanceLifeStats(FCreatureLifeState& State, const FCreatureMetabolismRates& Rates, float Interval, const FCreatureWeatherRates& Weather);
+
+	static bool CanReproduce(const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates);
+	static bool IsDead(const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates);
+
+	static void ConsumeFood(FCreatureLifeState& State, float FoodValue);
+
+	// Energy cost and cooldown paid by each parent
+	static void ApplyReproductionCost(FCreatureLifeState& State, float ReproductionRate);
+
+	// Returns the damage taken after resistance
+	static float ApplyDamage(FCreatureLifeState& State, float DamageAmount, float DamageResistance);
+
+	static float CalculateFitness(const FCreatureGenes& Genes, const FCreatureLifeState& State);
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CreaturePoolSubsystem.generated.h"
+
+class ACreature;
+
+USTRUCT(BlueprintType)
+struct ECOSYSTEMSANDBOX_API FCreaturePoolStats
+{
+	GENERATED_BODY()
+
+	// Acquires served from the pool
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Hits = 0;
+
+	// Acquires that had to spawn a new actor
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Misses = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Releases = 0;
+
+	// Releases destroyed because the pool was full
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Overflows = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 PooledCount = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float HitRate = 0.0f;
+
+	// Measured cost of a SpawnActor on a miss
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float AverageSpawnMs = 0.0f;
+
+	// Measured cost of a Destroy on an overflow
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float AverageDestroyMs = 0.0f;
+
+	// Spawn and destroy time avoided by reuse, garbage collection is measured separately below
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float EstimatedTimeSavedMs = 0.0f;
+
+	// Actors kept out of garbage collection by reuse
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 DestroysAvoided = 0;
+
+	// False when MaxPooledCreatures is 0 and every release is destroyed, for comparing the GC numbers below
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	bool bPoolingEnabled = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 GarbageCollections = 0;
+
+	// Game thread time from the pre to the post garbage collect delegate, incremental purging after it is not included
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float GarbageCollectionMs = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float MaxGarbageCollectionMs = 0.0f;
+
+	// Generations counted by NotifyGenerationComplete
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Generations = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float GarbageCollectionMsPerGeneration = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float LastGenerationGarbageCollectionMs = 0.0f;
+};
+
+/**
+ * Keeps dead creatures deactivated in place and hands them back out instead of
+ * spawning and destroying actors every generation. A reused creature is reset
+ * through ACreature::ResetForReuse and then reinitialized with InitializeWithGenes.
+ */
+UCLASS()
+class ECOSYSTEMSANDBOX_API UCreaturePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Returns a pooled creature of CreatureClass reset at Transform, or spawns a new one
+	UFUNCTION(BlueprintCallable, Category = "Creature Pool")
+	ACreature* AcquireCreature(TSubclassOf<ACreature> CreatureClass, const FTransform& Transform);
+
+	// Deactivates the creature and keeps it for reuse, destroys it when the pool is full
+	UFUNCTION(BlueprintCallable, Category = "Creature Pool")
+	void ReleaseCreature(ACreature* Creature);
+
+	UFUNCTION(BlueprintCallable, Category = "Creature Pool")
+	void SetMaxPooledCreatures(int32 NewMax);
+
+	UFUNCTION(BlueprintCallable, Category = "Creature Pool")
+	FCreaturePoolStats GetPoolStats() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Creature Pool")
+	void ResetPoolStats();
+
+	// Closes the current generation's garbage collection total, called when its creatures are released
+	void NotifyGenerationComplete();
+
+private:
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	UPROPERTY()
+	TArray<ACreature*> PooledCreatures;
+
+	int32 MaxPooledCreatures = 1024;
+
+	// Counters
+	int32 Hits = 0;
+	int32 Misses = 0;
+	int32 Releases = 0;
+	int32 Overflows = 0;
+	double TotalSpawnSeconds = 0.0;
+	double TotalDestroySeconds = 0.0;
+
+	// Garbage collection, the delegates are global so collections for other worlds are counted too
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+	double GarbageCollectStartTime = 0.0;
+	int32 GarbageCollections = 0;
+	double TotalGarbageCollectSeconds = 0.0;
+	double MaxGarbageCollectSeconds = 0.0;
+	double GenerationGarbageCollectSeconds = 0.0;
+	double LastGenerationGarbageCollectSeconds = 0.0;
+	int32 Generations = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CreatureSignificanceSubsystem.generated.h"
+
+class ACreature;
+
+// Tick rate tiers, from every frame down to a few times per second
+UENUM(BlueprintType)
+enum class ECreatureSignificance : uint8
+{
+	Full	UMETA(DisplayName = "Full"),
+	High	UMETA(DisplayName = "High"),
+	Medium	UMETA(DisplayName = "Medium"),
+	Low		UMETA(DisplayName = "Low")
+};
+
+/**
+ * Sorts creatures into tick rate tiers so that only the few hundred that matter tick every frame.
+ * A creature's tier comes from its distance to the nearest player view or point of interest, raised
+ * while it fights, flees, mates or has recently interacted, and lowered while it idles or dies. The
+ * tier becomes a tick interval on the creature, its controller and their components. The engine
+ * passes interval ticks the time since their last tick, so movement and behavior trees still see
+ * the full elapsed time. Creatures are re-evaluated round robin over RefreshSeconds, which also
+ * spreads their interval ticks over different frames. Low creatures also hibernate in
+ * UCreatureSimulationSubsystem, so their life stats are only caught up when needed.
+ */
+UCLASS()
+class ECOSYSTEMSANDBOX_API UCreatureSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 NumTiers = 4;
+
+	// Tick interval per tier in seconds
+	static constexpr float TierTickIntervals[NumTiers] = { 0.0f, 0.066f, 0.2f, 0.5f };
+
+	// Distance to the nearest view or point of interest below which each of the first three tiers applies
+	static constexpr float TierDistances[NumTiers - 1] = { 2500.0f, 6000.0f, 15000.0f };
+
+	// Creatures only fall to a less significant tier once this much further than its distance
+	static constexpr float DemotionHysteresis = 1.1f;
+
+	// Creatures that interacted this recently tick at least at High
+	static constexpr float InteractionGraceSeconds = 3.0f;
+
+	// Time over which every creature is evaluated once
+	static constexpr float RefreshSeconds = 0.25f;
+
+	// The full rate distance is pulled in so that about this many creatures are inside it
+	static constexpr int32 MaxFullRateCreatures = 256;
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Starts the creature at Full, it settles into its tier within RefreshSeconds
+	void Register(ACreature* Creature);
+
+	// Restores every frame ticking and frees the creature's slot
+	void Unregister(ACreature* Creature);
+
+	// Raises the creature to High right away instead of at its next evaluation
+	void NotifyInteraction(ACreature* Creature);
+
+	// Actors other than the player views near which creatures tick at full rate
+	UFUNCTION(BlueprintCallable, Category = "Creature Significance")
+	void AddPointOfInterest(AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "Creature Significance")
+	void RemovePointOfInterest(AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "Creature Significance")
+	ECreatureSignificance GetSignificance(const ACreature* Creature) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Creature Significance")
+	int32 GetNumInTier(ECreatureSignificance Tier) const { return TierCounts[static_cast<int32>(Tier)]; }
+
+	// Duration of the last evaluation slice
+	UFUNCTION(BlueprintCallable, Category = "Creature Significance")
+	float GetLastUpdateMs() const { return LastUpdateMs; }
+
+private:
+	void GatherViewpoints();
+	void UpdateFullRateDistance();
+	ECreatureSignificance Evaluate(const ACreature* Creature, ECreatureSignificance Current, float DistanceSquared, float Now) const;
+	void SetTier(int32 Slot, ECreatureSignificance Tier);
+
+	// Indexed like Creatures
+	UPROPERTY()
+	TArray<ACreature*> Creatures;
+
+	TArray<ECreatureSignificance> Tiers;
+
+	// Distance to the nearest viewpoint at the last evaluation
+	TArray<float> ViewDistancesSquared;
+	TArray<float> NearDistancesSquared;
+
+	UPROPERTY()
+	TArray<TWeakObjectPtr<AActor>> PointsOfInterest;
+
+	// Player views and points of interest, gathered once per tick
+	TArray<FVector> Viewpoints;
+
+	// Set once per round robin pass from the last distances
+	float FullRateDistanceSquared = FMath::Square(TierDistances[0]);
+
+	int32 TierCounts[NumTiers] = {};
+	int32 NextSlot = 0;
+	float LastUpdateMs = 0.0f;
+};
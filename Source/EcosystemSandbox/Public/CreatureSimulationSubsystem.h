@@ -0,0 +1,133 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CreatureMetabolism.h"
+#include "CreatureSimulationSubsystem.generated.h"
+
+class ACreature;
+class ADynamicWeatherSystem;
+
+/**
+ * Steps the life stats of every living creature in one pass per UEcosystemClockSubsystem step instead of one actor tick each.
+ * Energy, hunger, age, health, cooldown and the metabolism rates live in FCreatureLifeColumns, which
+ * FCreatureMetabolism steps a field at a time. Creatures only hear back on transitions: death, a change
+ * in reproduction readiness, or energy or hunger moving far enough to matter to their behavior tree.
+ *
+ * Hibernating creatures are not stepped at all. Their stats are caught up in closed form by
+ * FCreatureMetabolism::AdvanceLifeStats whenever they are read, when they wake, at their predicted death
+ * and at least every MaxHibernationSeconds. The catch-up uses the average weather while they slept.
+ */
+UCLASS()
+class ECOSYSTEMSANDBOX_API UCreatureSimulationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Change in energy or hunger that is pushed to a creature's blackboard
+	static constexpr float BlackboardThreshold = 1.0f;
+
+	// Change in the weather's movement modifier that is pushed to every creature
+	static constexpr float MovementModifierThreshold = 0.01f;
+
+	// Longer clock steps are integrated in closed form, stepping them would overshoot the health thresholds
+	static constexpr float MaxSteppedDeltaTime = 0.1f;
+
+	// Longest a hibernating creature goes without being caught up and having its blackboard refreshed
+	static constexpr float MaxHibernationSeconds = 60.0f;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// Takes over the creature's stepped life stats until it is unregistered, returns its slot
+	int32 Register(ACreature* Creature, const FCreatureLifeState& State, const FCreatureMetabolismRates& Rates);
+
+	// Writes the stats back to the creature and frees its slot
+	void Unregister(ACreature* Creature);
+
+	// Stops stepping the creature every clock step until it is woken
+	void Hibernate(ACreature* Creature);
+
+	// Catches the creature up and steps it every clock step again
+	void Wake(ACreature* Creature);
+
+	// Stepped stats of a registered creature, caught up to now when it hibernates
+	void GetState(const ACreature* Creature, FCreatureLifeState& InOutState) const;
+	void SetState(const ACreature* Creature, const FCreatureLifeState& State);
+	void SetRates(const ACreature* Creature, const FCreatureMetabolismRates& Rates);
+
+	// Creatures stepped every clock step
+	UFUNCTION(BlueprintCallable, Category = "Creature Simulation")
+	int32 GetNumSimulated() const { return Creatures.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Creature Simulation")
+	int32 GetNumHibernating() const { return SleepingCreatures.Num(); }
+
+	// Duration of the last clock step
+	UFUNCTION(BlueprintCallable, Category = "Creature Simulation")
+	float GetLastUpdateMs() const { return LastUpdateMs; }
+
+private:
+	struct FHibernation
+	{
+		// Simulated time the row's stats were last brought up to date
+		double Start = 0.0;
+
+		// Weather integrals at Start
+		double WeatherEnergyDecay = 0.0;
+		double WeatherHealing = 0.0;
+
+		// Predicted death or the longest hibernation, whichever comes first
+		double WakeTime = 0.0;
+	};
+
+	void Step(float DeltaTime);
+	void NotifyTransitions();
+	void WakeDue();
+
+	void RemoveAwake(int32 Slot);
+	void RemoveSleeping(int32 SleepSlot);
+
+	// Brings the row of a hibernating creature up to now
+	void CatchUp(int32 SleepSlot);
+
+	// Predicts when the up to date row must wake, with the present weather standing in for the weather ahead
+	void Schedule(int32 SleepSlot);
+
+	FCreatureWeatherRates GetAverageWeather(const FHibernation& Hibernation) const;
+
+	// Indexed like Columns
+	UPROPERTY()
+	TArray<ACreature*> Creatures;
+
+	FCreatureLifeColumns Columns;
+
+	// Last values each creature's blackboard was given
+	TArray<float> NotifiedEnergy;
+	TArray<float> NotifiedHunger;
+	TArray<uint8> NotifiedCanReproduce;
+
+	// Filled per step, 1 for creatures that must hear about their stats, 2 for those that died
+	TArray<uint8> Transitions;
+
+	// Hibernating creatures, indexed like SleepingColumns, whose rows hold the stats as of their Start
+	UPROPERTY()
+	TArray<ACreature*> SleepingCreatures;
+
+	FCreatureLifeColumns SleepingColumns;
+	TArray<FHibernation> Hibernations;
+
+	// Time since the world began play, and the weather rates integrated over it
+	double SimulatedSeconds = 0.0;
+	double WeatherEnergyDecay = 0.0;
+	double WeatherHealing = 0.0;
+
+	FCreatureWeatherRates WeatherRates;
+
+	UPROPERTY()
+	ADynamicWeatherSystem* WeatherSystem = nullptr;
+
+	float MovementModifier = 1.0f;
+	float LastUpdateMs = 0.0f;
+};
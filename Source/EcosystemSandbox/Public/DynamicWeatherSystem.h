@@ -218,6 +218,7 @@ protected:
 	// Internal Functions
 	void InitializeComponents();
 	void SetupLumenGlobalIllumination();
+	void StepSimulation(float StepSeconds);
 	void UpdateTimeOfDay(float DeltaTime);
 	void UpdateWeatherEffects(float DeltaTime);
 	void UpdateSunPosition();
@@ -235,7 +236,7 @@ private:
 	bool bWeatherTransitioning = false;
 
 	// Time tracking
-	float LastWeatherChangeTime = 0.0f;
+	double LastWeatherChangeTime = 0.0;
 	ETimeOfDay CurrentTimeOfDay = ETimeOfDay::Noon;
 	ETimeOfDay PreviousTimeOfDay = ETimeOfDay::Noon;
 
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EcosystemClockSubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSimulationStep, float /*StepSeconds*/);
+
+/**
+ * Fixed timestep clock of the ecosystem. Real frame time scaled by TimeScale is accumulated and
+ * spent in steps of exactly FixedDeltaTime, so metabolism, weather, cooldowns and generation timers
+ * advance the same way at any frame rate and time scale. A frame runs as many steps as the time scale
+ * asks for until StepBudgetMs of wall time is spent, or MaxSubstepsPerFrame when that is set. Time
+ * that does not fit is dropped rather than carried into ever longer frames, with a warning.
+ *
+ * Fast-forward ignores TimeScale and steps for FastForwardBudgetMs of wall time every frame, as fast
+ * as the machine allows, and logs the simulated seconds achieved per wall second. It is meant for
+ * headless worlds and is turned on by -FastForward on the command line.
+ *
+ * Movement, physics and behavior trees run on engine time, which follows TimeScale through the world
+ * time dilation only up to MaxWorldTimeDilation, beyond that they fall behind the ecosystem.
+ */
+UCLASS()
+class ECOSYSTEMSANDBOX_API UEcosystemClockSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Broadcast once per fixed step
+	FOnSimulationStep OnSimulationStep;
+
+	// Simulated time, or world time when World has no clock
+	static double GetSimulationSeconds(const UWorld* World);
+	double GetSimulationSeconds() const { return SimulationSeconds; }
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	void SetRunning(bool bNewRunning);
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	bool IsRunning() const { return bRunning; }
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	void SetTimeScale(float NewTimeScale);
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	void SetFixedDeltaTime(float NewFixedDeltaTime);
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	void SetStepBudgetMs(float NewStepBudgetMs);
+
+	// 0 leaves the step count to the budget
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	void SetMaxSubstepsPerFrame(int32 NewMaxSubsteps);
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	void SetMaxWorldTimeDilation(float NewMaxWorldTimeDilation);
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	void SetFastForward(bool bNewFastForward);
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	bool IsFastForward() const { return bFastForward; }
+
+	// Simulated seconds per wall second over the last measurement window
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	float GetAchievedTimeScale() const { return AchievedTimeScale; }
+
+	// Scaled frame time dropped because it did not fit in the step budget, since the clock started
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem Clock")
+	float GetDroppedSeconds() const { return static_cast<float>(DroppedSeconds); }
+
+private:
+	void Step();
+	void ApplyWorldTimeDilation();
+
+	float FixedDeltaTime = 1.0f / 30.0f;
+	float StepBudgetMs = 10.0f;
+	int32 MaxSubstepsPerFrame = 0;
+	float TimeScale = 1.0f;
+	float MaxWorldTimeDilation = 4.0f;
+	float FastForwardBudgetMs = 50.0f;
+	bool bFastForward = false;
+	bool bRunning = true;
+
+	double SimulationSeconds = 0.0;
+	double Accumulator = 0.0;
+	double DroppedSeconds = 0.0;
+
+	// Achieved time scale is measured over windows of about a wall second
+	double WindowStartWallSeconds = 0.0;
+	double WindowStartSimulationSeconds = 0.0;
+	double WindowDroppedSeconds = 0.0;
+	float AchievedTimeScale = 0.0f;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EcosystemHeadlessCommandlet.generated.h"
+
+/**
+ * Runs the genetic algorithm through FIslandEvolution without a world or rendering.
+ *
+ * UnrealEditor-Cmd EcosystemSandbox.uproject -run=EcosystemHeadless -nullrhi -Generations=1000 -Population=50 -Seed=1
+ *
+ * Optional: -MutationRate= -MutationStrength= -Mutation=Fixed|SelfAdaptive -ElitePercentage= -Selection=Truncation|Tournament|StochasticUniversal|NSGA2
+ * -TournamentSize= -MinPopulation= -MaxPopulation= -TimeLimit= -TimeStep= -ReportEvery= -Csv=<path>
+ * -Islands= -Topology=Ring|FullyConnected|Random -MigrationInterval= -Migrants=
+ * -Novelty=<weight 0-1> -NoveltyNeighbors= -NoveltyArchiveFraction=
+ * -Species=<clusters per island> -NoFitnessSharing
+ *
+ * -TargetFitness= reports the first generation whose best creature reached it, run the same seed
+ * with -Mutation=Fixed and -Mutation=SelfAdaptive to compare generations to target.
+ */
+UCLASS()
+class ECOSYSTEMSANDBOX_API UEcosystemHeadlessCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UEcosystemHeadlessCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
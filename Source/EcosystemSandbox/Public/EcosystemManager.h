@@ -4,6 +4,20 @@
 #include "GameFramework/Actor.h"
 #include "Engine/DataTable.h"
 #include "CreatureGenetics.h"
+#include "GenePool.h"
+#include "LineageArena.h"
+#include "GeneticSelection.h"
+#include "MultiObjectiveSelection.h"
+#include "PopulationAggregates.h"
+#include "QuantileSketch.h"
+#include "GenomeFitnessCache.h"
+#include "CreatureHistoryLog.h"
+#include "EcosystemSnapshot.h"
+#include "HeadlessEvolution.h"
+#include "NoveltyArchive.h"
+#include "Speciation.h"
+#include "IslandModel.h"
+#include "Tasks/Task.h"
 #include "EcosystemManager.generated.h"
 
 class ACreature;
@@ -28,32 +42,52 @@ struct ECOSYSTEMSANDBOX_API FPopulationStats
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	FCreatureGenes DominantGenes;
 
+	// Fitness distribution of the last completed generation, see AEcosystemManager::GetQuantileHistory
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	TMap<EMovementType, int32> MovementTypeDistribution;
+	FQuantileSummary FitnessQuantiles;
 
+	// Species of the last completed generation, island by island, empty when speciation is off
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	TMap<EAggressionLevel, int32> AggressionDistribution;
+	TArray<FSpeciesStats> Species;
+
+	// Indexed by EMovementType, read from Blueprints through AEcosystemManager::GetMovementTypeCount
+	UPROPERTY(VisibleAnywhere)
+	int32 MovementTypeDistribution[(int32)EMovementType::Count] = {};
+
+	// Indexed by EAggressionLevel
+	UPROPERTY(VisibleAnywhere)
+	int32 AggressionDistribution[(int32)EAggressionLevel::Count] = {};
+};
+
+UENUM(BlueprintType)
+enum class ESpawnPriority : uint8
+{
+	Elite		UMETA(DisplayName = "Elite"),
+	Offspring	UMETA(DisplayName = "Offspring"),
+	Birth		UMETA(DisplayName = "Birth"),
+	Count		UMETA(Hidden)
 };
 
 USTRUCT(BlueprintType)
-struct ECOSYSTEMSANDBOX_API FCreatureRecord
+struct ECOSYSTEMSANDBOX_API FSpawnQueueStats
 {
 	GENERATED_BODY()
 
-	UPROPERTY()
-	FCreatureGenes Genes;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 QueueDepth = 0;
 
-	UPROPERTY()
-	float FitnessScore = 0.0f;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 SpawnedLastFrame = 0;
 
-	UPROPERTY()
-	float LifeTime = 0.0f;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 TotalSpawned = 0;
 
-	UPROPERTY()
-	int32 Generation = 0;
+	// Time from queueing to spawning
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float AverageLatencyMs = 0.0f;
 
-	UPROPERTY()
-	int32 OffspringCount = 0;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float MaxLatencyMs = 0.0f;
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGenerationComplete, int32, GenerationNumber);
@@ -69,6 +103,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
 
 	// Ecosystem Configuration
@@ -87,22 +122,107 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ecosystem Configuration")
 	TSubclassOf<ACreature> CreatureClass;
 
+	// Game thread time spent draining the spawn queue per frame, at least one creature spawns each frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ecosystem Configuration", meta = (ClampMin = "0.1"))
+	float SpawnBudgetMs = 2.0f;
+
+	// Dead creatures kept deactivated for reuse instead of being destroyed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ecosystem Configuration", meta = (ClampMin = "0"))
+	int32 MaxPooledCreatures = 1024;
+
 	// Genetic Algorithm Parameters
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
 	float MutationRate = 0.1f;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm", meta = (EditCondition = "MutationMode == EMutationMode::Fixed"))
 	float MutationStrength = 0.2f;
 
+	// Self-adaptive mutation evolves a step size per genome instead of using MutationStrength
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
+	EMutationMode MutationMode = EMutationMode::Fixed;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
 	float ElitePercentage = 0.2f;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
+	ESelectionStrategy SelectionStrategy = ESelectionStrategy::Truncation;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm", meta = (ClampMin = "1", EditCondition = "SelectionStrategy == ESelectionStrategy::Tournament"))
+	int32 TournamentSize = 3;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
 	bool bAutoGenerationAdvance = true;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
 	float GenerationTimeLimit = 300.0f; // 5 minutes
 
+	// Evolve without spawning creatures, using the data-only simulation in FHeadlessEvolution
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
+	bool bHeadlessMode = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm", meta = (ClampMin = "1", EditCondition = "bHeadlessMode"))
+	int32 HeadlessGenerationsPerTick = 10;
+
+	// Seed for every random stream in the simulation, 0 picks a new seed on each initialize
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Genetic Algorithm")
+	int32 RandomSeed = 0;
+
+	// Sub-populations bred separately, each in its own angular sector of the spawn radius.
+	// Empty evolves a single population of InitialPopulation with the settings above.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Island Model")
+	TArray<FIslandConfig> Islands;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Island Model")
+	EMigrationTopology MigrationTopology = EMigrationTopology::Ring;
+
+	// Generations between migrations, 0 keeps the islands isolated
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Island Model", meta = (ClampMin = "0"))
+	int32 MigrationInterval = 5;
+
+	// Best genomes each island sends to each of its neighbours
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Island Model", meta = (ClampMin = "0"))
+	int32 MigrantCount = 2;
+
+	// Share of the selection score taken by genetic novelty, the mean distance to the nearest genomes of earlier
+	// generations. 0 selects on fitness alone, 1 is pure novelty search. NSGA-II selection ignores it.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Novelty Search", meta = (ClampMin = "0", ClampMax = "1"))
+	float NoveltyWeight = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Novelty Search", meta = (ClampMin = "1", EditCondition = "NoveltyWeight > 0"))
+	int32 NoveltyNeighbors = 15;
+
+	// Most novel share of every generation kept in the archive
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Novelty Search", meta = (ClampMin = "0", ClampMax = "1", EditCondition = "NoveltyWeight > 0"))
+	float NoveltyArchiveFraction = 0.05f;
+
+	// Every generation each island is clustered into this many species by k-means over normalized traits, 0 disables speciation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speciation", meta = (ClampMin = "0"))
+	int32 NumSpecies = 0;
+
+	// Divides fitness by species size before selection, so a crowded niche cannot crowd out the others
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speciation", meta = (EditCondition = "NumSpecies > 0"))
+	bool bSpeciesFitnessSharing = true;
+
+	// Snapshot written by SaveGenerationData and read by LoadGenerationData, under Saved/EcosystemSnapshots
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Snapshots")
+	FString SnapshotName = TEXT("Latest");
+
+	// Death records kept in memory, older ones are only in the history log on disk
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ClampMin = "1"))
+	int32 HistoryCapacity = 4096;
+
+	// Records buffered before each append to the history log
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ClampMin = "1"))
+	int32 HistoryFlushBatchSize = 256;
+
+	// Number of best records kept for GetTopPerformers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ClampMin = "1"))
+	int32 TopPerformerCapacity = 100;
+
+	// Genome evaluations kept for reuse by later spawns of the same or a near-identical genome
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fitness Cache", meta = (ClampMin = "1"))
+	int32 FitnessCacheCapacity = 4096;
+
 	// Current State
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Current State")
 	FPopulationStats CurrentStats;
@@ -110,9 +230,6 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Current State")
 	TArray<ACreature*> ActiveCreatures;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Current State")
-	TArray<FCreatureRecord> CreatureHistory;
-
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Current State")
 	float CurrentGenerationTime = 0.0f;
 
@@ -134,31 +251,104 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	void AdvanceGeneration();
 
+	// Fast-forwards Count generations without actors, then respawns the result unless bHeadlessMode is set
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	void RunHeadlessGenerations(int32 Count);
+
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	ACreature* SpawnCreature(const FCreatureGenes& Genes, const FVector& Location = FVector::ZeroVector);
 
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	void RemoveCreature(ACreature* Creature);
 
+	// Spawns the creature on a later frame within SpawnBudgetMs, higher priorities first
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	void QueueSpawn(const FCreatureGenes& Genes, const FVector& Location, ESpawnPriority Priority);
+
+	UFUNCTION(BlueprintPure, Category = "Ecosystem")
+	int32 GetSpawnQueueDepth() const { return PendingSpawnCount; }
+
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	FSpawnQueueStats GetSpawnQueueStats() const { return SpawnQueueStats; }
+
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	FPopulationStats GetCurrentStats() const { return CurrentStats; }
 
+	// Hits and misses of the genome evaluation caches, including those of a running headless evolution
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	FGenomeCacheStats GetFitnessCacheStats() const;
+
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	TArray<FCreatureGenes> GetTopPerformers(int32 Count = 10) const;
 
+	// Fitness and trait quantiles of every completed generation this run, oldest first
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	TArray<FGenerationQuantiles> GetQuantileHistory() const { return QuantileHistory; }
+
+	// Most recent death records, oldest first
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	TArray<FCreatureRecord> GetRecentHistory(int32 Count = 100) const { return HistoryLog.GetRecent(Count); }
+
+	// Binary log of every death record this run, readable with FCreatureHistoryLogReader
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	FString GetHistoryLogPath() const { return HistoryLog.GetPath(); }
+
+	// Living creatures descended from each founder through either parent, keyed by the founder's lineage id
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	TMap<int32, int32> GetLivingDescendantsPerFounder() const;
+
+	// Parentage of every creature this run
+	const FLineageArena& GetLineage() const { return Lineage; }
+
+	UFUNCTION(BlueprintPure, Category = "Ecosystem")
+	int32 GetMovementTypeCount(EMovementType MovementType) const { return CurrentStats.MovementTypeDistribution[(int32)MovementType]; }
+
+	UFUNCTION(BlueprintPure, Category = "Ecosystem")
+	int32 GetAggressionLevelCount(EAggressionLevel AggressionLevel) const { return CurrentStats.AggressionDistribution[(int32)AggressionLevel]; }
+
+	// Writes a snapshot of the run in the background
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	void SaveGenerationData();
 
+	// Resumes the run from the last snapshot, creatures respawn through the spawn queue
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	void LoadGenerationData();
 
+	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
+	FString GetSnapshotPath() const;
+
+	UFUNCTION(BlueprintPure, Category = "Ecosystem")
+	int32 GetIslandCount() const { return FMath::Max(1, Islands.Num()); }
+
+	// Island whose sector of the spawn radius contains Location
+	UFUNCTION(BlueprintPure, Category = "Ecosystem")
+	int32 GetIslandIndex(const FVector& Location) const;
+
 protected:
 	// Internal Functions
 	void UpdatePopulationStats();
 	void CheckGenerationConditions();
-	FVector GetRandomSpawnLocation() const;
-	TArray<FCreatureGenes> SelectParentsForReproduction() const;
+	FVector GetRandomSpawnLocation(FSimulationRandomStream& Stream, int32 Island = 0) const;
+	void GatherPopulationSnapshot(TArray<FGenePool>& OutIslandGenes, TArray<TArray<float>>& OutIslandFitness, TArray<FFitnessObjectives>& OutIslandObjectives) const;
+	void QueueIslandPopulations(TConstArrayView<FGenePool> IslandPopulations, TConstArrayView<int32> EliteCounts);
+	void FinishGeneration();
+	void WaitForBreeding();
 	void CleanupDeadCreatures();
+	void ReleaseAllCreatures();
+	void ProcessSpawnQueue();
+	void ClearSpawnQueue();
+	void WaitForSave();
+	void OpenHistoryLog();
+	FHeadlessEvolutionParams MakeHeadlessParams() const;
+	FNoveltySearchParams MakeNoveltyParams() const;
+	FSpeciationParams MakeSpeciationParams() const;
+	TArray<FIslandConfig> GetIslandConfigs() const;
+	FMigrationParams MakeMigrationParams() const;
+	ACreature* SpawnCreatureWithId(const FCreatureGenes& Genes, const FVector& Location, int32 CreatureId, uint32 Parent1, uint32 Parent2, uint32 LineageId = FLineageArena::InvalidId);
+	void QueueSpawnWithId(const FCreatureGenes& Genes, const FVector& Location, ESpawnPriority Priority, int32 CreatureId, uint32 Parent1, uint32 Parent2);
+	void RecordTopPerformer(const FCreatureRecord& Record);
+	void StepSimulation(float StepSeconds);
+	void OnCreatureFitnessChanged(ACreature* Creature);
 
 	UFUNCTION()
 	void OnCreatureDeath(ACreature* DeadCreature, float FitnessScore);
@@ -171,7 +361,68 @@ private:
 	float LastStatsUpdateTime = 0.0f;
 	float StatsUpdateInterval = 1.0f;
 
-	// Generation management
+	// Running fitness sums, leader and trait counts of ActiveCreatures
+	FPopulationAggregates Aggregates;
+	ACreature* DominantCreature = nullptr;
+
+	FCreatureHistoryLog HistoryLog;
+
+	FGenomeFitnessCache FitnessCache;
+
+	FLineageArena Lineage;
+
+	// Creatures of the current generation, deaths are added as they happen and survivors when it ends
+	FPopulationSketch GenerationSketch;
+	TArray<FGenerationQuantiles> QuantileHistory;
+
+	// Min-heap on fitness of the best records seen so far
+	TArray<FCreatureRecord> TopPerformerHeap;
+
+	// Random streams
+	uint64 ActiveSeed = 0;
+	int32 NextCreatureId = 0;
+
+	// Spawn queue, one FIFO per priority
+	struct FPendingSpawn
+	{
+		FCreatureGenes Genes;
+		FVector Location;
+		double QueueTime;
+
+		// Reserved when queued, so it keys the spawn stream before the creature exists
+		int32 CreatureId = INDEX_NONE;
+
+		// Lineage record is appended with these parents once the creature spawns
+		uint32 Parents[2] = { FLineageArena::InvalidId, FLineageArena::InvalidId };
+
+		// Existing record of a creature restored from a snapshot
+		uint32 LineageId = FLineageArena::InvalidId;
+
+		// Set for creatures restored from a snapshot
+		bool bRestoreState = false;
+		FCreatureLifeState LifeState;
+		FSimulationRandomStream RandomStream;
+	};
+
+	void EnqueueSpawn(FPendingSpawn&& Pending, ESpawnPriority Priority);
+
+	TArray<FPendingSpawn> SpawnQueues[(int32)ESpawnPriority::Count];
+	int32 SpawnQueueHeads[(int32)ESpawnPriority::Count] = {};
+	int32 PendingSpawnCount = 0;
+	double TotalSpawnLatency = 0.0;
+	float DefaultTickInterval = 0.1f;
+	FSpawnQueueStats SpawnQueueStats;
+
+	TUniquePtr<FIslandEvolution> HeadlessEvolution;
+
+	// Generation management, one gene pool per island
+	TArray<int32> PendingEliteCounts;
 	bool bGenerationInProgress = false;
-	TArray<FCreatureGenes> PendingOffspring;
+	UE::Tasks::TTask<TArray<FGenePool>> BreedingTask;
+
+	// One per island, only used by the breeding task while it runs
+	TArray<TSharedPtr<FNoveltyArchive>> NoveltyArchives;
+	TArray<TSharedPtr<FSpeciation>> Speciations;
+
+	UE::Tasks::FTask SaveTask;
 };
@@ -45,6 +45,34 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
 	float SimulationTimeScale = 1.0f;
 
+	// Seconds of ecosystem time per simulation step
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
+	float FixedTimeStep = 1.0f / 30.0f;
+
+	// Wall time per frame spent on simulation steps, scaled time beyond it is dropped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
+	float StepBudgetMs = 10.0f;
+
+	// Optional limit on steps per frame on top of the budget, 0 for none
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
+	int32 MaxSubstepsPerFrame = 0;
+
+	// Engine movement and physics follow SimulationTimeScale only up to this dilation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
+	float MaxWorldTimeDilation = 4.0f;
+
+	// Steps as fast as the machine allows, for headless runs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation")
+	bool bFastForward = false;
+
+	// Simulated seconds per real second actually reached, below SimulationTimeScale while time is dropped
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Simulation")
+	float AchievedTimeScale = 0.0f;
+
+	// Simulated time dropped because it did not fit in the step budget
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Simulation")
+	float DroppedSimulationSeconds = 0.0f;
+
 public:
 	UFUNCTION(BlueprintCallable, Category = "Ecosystem")
 	void StartSimulation();
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureHistoryLog.h"
+#include "CreatureLifeState.h"
+#include "LineageArena.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+struct FEcosystemSnapshotHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x504E5345; // "ESNP"
+	static constexpr uint32 CurrentVersion = 6;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	uint32 HeaderSize = sizeof(FEcosystemSnapshotHeader);
+	uint32 CreatureRecordSize = 0;
+	uint32 HistoryRecordSize = 0;
+
+	// Simulation state
+	int32 Generation = 0;
+	int32 NextCreatureId = 0;
+	float GenerationTime = 0.0f;
+	uint64 Seed = 0;
+
+	// Sections, each aligned to SectionAlignment from the start of the file
+	uint32 NumCreatures = 0;
+	uint32 NumHistory = 0;
+	uint32 NumTopPerformers = 0;
+	uint32 NumLineage = 0;
+	uint64 CreaturesOffset = 0;
+	uint64 HistoryOffset = 0;
+	uint64 TopPerformersOffset = 0;
+	uint64 LineageOffset = 0;
+};
+
+struct FSnapshotCreatureRecord
+{
+	FPackedGenome Genome;
+	FCreatureLifeState LifeState;
+
+	// Queued creatures already have their id reserved
+	int32 CreatureId;
+	uint32 RandomCounter;
+	uint64 RandomKey;
+
+	float Location[3];
+
+	// Spawned creatures keep their lineage record, queued ones only have their parents until they spawn.
+	// A valid LineageId is what marks a record whose life state and random stream are restored.
+	uint32 LineageId;
+	uint32 LineageParents[2];
+};
+
+static_assert(sizeof(FSnapshotCreatureRecord) == 104, "Snapshot creature layout changed, bump FEcosystemSnapshotHeader::CurrentVersion");
+
+/**
+ * Everything needed to resume a run: active genomes and life stats, the history tail,
+ * the best records, the lineage arena, the generation counter and random stream state.
+ *
+ * The file is a fixed header followed by arrays of fixed-size records, so loading maps
+ * it and reads records in place without any parsing.
+ */
+struct ECOSYSTEMSANDBOX_API FEcosystemSnapshot
+{
+	static constexpr uint64 SectionAlignment = 16;
+
+	FEcosystemSnapshotHeader Header;
+	TArray<FSnapshotCreatureRecord> Creatures;
+	TArray<FCreatureHistoryDiskRecord> History;
+	TArray<FCreatureHistoryDiskRecord> TopPerformers;
+	TArray<FLineageRecord> Lineage;
+
+	// Writes to a temporary file and renames it over Path, safe to call from any thread
+	bool SaveToFile(const FString& Path);
+};
+
+// Memory-mapped view of a snapshot file
+class ECOSYSTEMSANDBOX_API FEcosystemSnapshotReader
+{
+public:
+	~FEcosystemSnapshotReader();
+
+	bool Open(const FString& Path);
+	void Close();
+
+	const FEcosystemSnapshotHeader& GetHeader() const { return *Header; }
+	TConstArrayView<FSnapshotCreatureRecord> GetCreatures() const;
+	TConstArrayView<FCreatureHistoryDiskRecord> GetHistory() const;
+	TConstArrayView<FCreatureHistoryDiskRecord> GetTopPerformers() const;
+	TConstArrayView<FLineageRecord> GetLineage() const;
+
+private:
+	template <typename RecordType>
+	TConstArrayView<RecordType> GetSection(uint64 Offset, uint32 Num) const
+	{
+		return TConstArrayView<RecordType>(reinterpret_cast<const RecordType*>(Data + Offset), Num);
+	}
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	const uint8* Data = nullptr;
+	const FEcosystemSnapshotHeader* Header = nullptr;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+#include "GeneTraits.h"
+#include "LineageArena.h"
+#include "SimulationRandom.h"
+
+/**
+ * Structure-of-arrays container for a population of genomes.
+ * Every trait is stored as its own contiguous column so the batched
+ * operations below run as flat per-column loops across the whole pool
+ * instead of walking one FCreatureGenes at a time.
+ */
+struct ECOSYSTEMSANDBOX_API FGenePool
+{
+	static constexpr int32 NumTraits = FGeneTraits::Num;
+
+	// Columns
+	TArray<float> Traits[NumTraits];
+	TArray<uint8> MovementTypes;
+	TArray<uint8> AggressionLevels;
+	TArray<FLinearColor> PrimaryColors;
+	TArray<FLinearColor> SecondaryColors;
+	TArray<float> StepSizes;
+
+	// FLineageArena ids a row's genome comes from: a row added from a creature holds its id twice,
+	// a bred row its two parents' ids and a random row InvalidId twice
+	TArray<uint32> Lineages[2];
+
+	int32 Num() const { return MovementTypes.Num(); }
+
+	// Empties every column, keeping room for ExpectedNum genomes
+	void Reset(int32 ExpectedNum = 0);
+
+	// Resizes every column without initializing new rows
+	void SetNumUninitialized(int32 NewNum);
+
+	// Row access
+	int32 Add(const FCreatureGenes& Genes, uint32 LineageId = FLineageArena::InvalidId);
+	void Set(int32 Index, const FCreatureGenes& Genes);
+	FCreatureGenes Get(int32 Index) const;
+	void CopyRow(const FGenePool& Source, int32 SourceIndex, int32 DestIndex);
+
+	// Batched operations draw row i from stream Streams.GetKey(i), so results
+	// do not depend on batch size or on how rows are split across threads.
+
+	// Appends Count random genomes
+	void GenerateRandomBatch(int32 Count, const FRandomStreamBatch& Streams);
+
+	// Mutates every genome from StartIndex to the end of the pool
+	void MutateAll(float MutationRate, float MutationStrength, const FRandomStreamBatch& Streams, int32 StartIndex = 0);
+
+	// Mutates Count genomes starting at StartIndex
+	void MutateRange(float MutationRate, float MutationStrength, const FRandomStreamBatch& Streams, int32 StartIndex, int32 Count);
+
+	// Self-adaptive mutation of Count genomes starting at StartIndex, see FCreatureGenes::MutateSelfAdaptive
+	void MutateRangeSelfAdaptive(float MutationRate, const FRandomStreamBatch& Streams, int32 StartIndex, int32 Count);
+
+	// Appends one offspring per parent index pair, inheriting each trait from either parent
+	void CrossoverBatch(const FGenePool& Parents, TConstArrayView<int32> Parent1Indices, TConstArrayView<int32> Parent2Indices, const FRandomStreamBatch& Streams);
+
+	// Writes one offspring per parent index pair into existing rows starting at DestIndex.
+	// Disjoint row ranges may be written from different threads.
+	void CrossoverInto(const FGenePool& Parents, TConstArrayView<int32> Parent1Indices, TConstArrayView<int32> Parent2Indices, const FRandomStreamBatch& Streams, int32 DestIndex);
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+#include "Templates/IntegerSequence.h"
+#include "Templates/IntegralConstant.h"
+
+// Continuous traits of FCreatureGenes, in column order
+enum class EGeneTrait : uint8
+{
+	Size,
+	Speed,
+	Strength,
+	Endurance,
+	ReproductionRate,
+	LifeSpan,
+	Intelligence,
+	VisionRange,
+	SocialTendency,
+	HungerResistance,
+	DamageResistance,
+	Count
+};
+
+struct FGeneTraitDescriptor
+{
+	float FCreatureGenes::* Member;
+	float Min;
+	float Max;
+
+	// Multiplies MutationStrength in fixed-strength mutation
+	float MutationScale;
+
+	constexpr float GetRange() const { return Max - Min; }
+
+	// Position within the range, 0 at Min and 1 at Max
+	float Normalize(float Value) const { return FMath::Clamp((Value - Min) / GetRange(), 0.0f, 1.0f); }
+
+	// Mirrors a value that stepped past a bound back into the range, so steps near a bound are not all absorbed by it
+	float Reflect(float Value) const
+	{
+		Value = Value < Min ? 2.0f * Min - Value : Value;
+		Value = Value > Max ? 2.0f * Max - Value : Value;
+
+		// Steps wider than the range still end up inside it
+		return FMath::Clamp(Value, Min, Max);
+	}
+};
+
+/**
+ * Compile-time description of every continuous trait. Mutation, crossover, random genomes, gene pool
+ * columns, novelty distance and packing all iterate this table, so a new trait is its FCreatureGenes
+ * property, its EGeneTrait entry and one row here. Ranges must match the ClampMin/ClampMax meta.
+ */
+struct FGeneTraits
+{
+	static constexpr int32 Num = static_cast<int32>(EGeneTrait::Count);
+
+	static constexpr FGeneTraitDescriptor Table[] =
+	{
+		{ &FCreatureGenes::Size,             0.1f,   5.0f,    1.0f },
+		{ &FCreatureGenes::Speed,            0.1f,   10.0f,   1.0f },
+		{ &FCreatureGenes::Strength,         0.1f,   3.0f,    1.0f },
+		{ &FCreatureGenes::Endurance,        0.1f,   2.0f,    1.0f },
+		{ &FCreatureGenes::ReproductionRate, 0.01f,  1.0f,    1.0f },
+		{ &FCreatureGenes::LifeSpan,         1.0f,   100.0f,  1.0f },
+		{ &FCreatureGenes::Intelligence,     0.1f,   3.0f,    1.0f },
+		{ &FCreatureGenes::VisionRange,      100.0f, 2000.0f, 1.0f },
+		{ &FCreatureGenes::SocialTendency,   0.1f,   2.0f,    1.0f },
+		{ &FCreatureGenes::HungerResistance, 0.1f,   3.0f,    1.0f },
+		{ &FCreatureGenes::DamageResistance, 0.1f,   3.0f,    1.0f },
+	};
+
+	static constexpr const FGeneTraitDescriptor& Get(EGeneTrait Trait) { return Table[static_cast<int32>(Trait)]; }
+
+	static float GetValue(const FCreatureGenes& Genes, EGeneTrait Trait) { return Genes.*Get(Trait).Member; }
+	static void SetValue(FCreatureGenes& Genes, EGeneTrait Trait, float Value) { Genes.*Get(Trait).Member = Value; }
+
+	// Calls Func(TIntegralConstant<int32, Trait>) for every trait, unrolled at compile time.
+	// Inside Func, Table[decltype(Trait)::Value] is a constant expression.
+	template <typename FuncType>
+	static FORCEINLINE void ForEach(FuncType&& Func)
+	{
+		ForEachImpl(Func, TMakeIntegerSequence<int32, Num>());
+	}
+
+private:
+	template <typename FuncType, int32... Traits>
+	static FORCEINLINE void ForEachImpl(FuncType& Func, TIntegerSequence<int32, Traits...>)
+	{
+		(Func(TIntegralConstant<int32, Traits>()), ...);
+	}
+};
+
+static_assert(UE_ARRAY_COUNT(FGeneTraits::Table) == FGeneTraits::Num, "Every EGeneTrait needs a row in FGeneTraits::Table");
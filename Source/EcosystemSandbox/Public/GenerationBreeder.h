@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenePool.h"
+#include "GeneticSelection.h"
+#include "MultiObjectiveSelection.h"
+
+struct FBreedingParams
+{
+	int32 PopulationSize = 0;
+	float MutationRate = 0.1f;
+	float MutationStrength = 0.2f;
+	EMutationMode MutationMode = EMutationMode::Fixed;
+	float ElitePercentage = 0.2f;
+	ESelectionStrategy SelectionStrategy = ESelectionStrategy::Truncation;
+	int32 TournamentSize = 3;
+	uint64 Seed = 0;
+	int32 Generation = 0;
+};
+
+/**
+ * Produces the genes of the next generation from a snapshot of the current one.
+ * Works purely on gene pools, so it can run on any thread. Offspring are bred in
+ * parallel chunks; each offspring slot draws from its own random stream, so the
+ * result is identical for any number of worker threads.
+ */
+struct ECOSYSTEMSANDBOX_API FGenerationBreeder
+{
+	// Rows bred per parallel task
+	static constexpr int32 ChunkSize = 512;
+
+	// Number of parents kept by truncation selection, elites are a share of it
+	static int32 GetTruncationCount(int32 PopulationNum);
+
+	// Number of leading rows of the next generation that are unchanged elites
+	static int32 GetEliteCount(int32 PopulationNum, const FBreedingParams& Params);
+
+	// Fills OutEliteRows with the rows copied unchanged, best first, and OutMatingPool with the rows offspring are bred from
+	static void SelectParents(TConstArrayView<float> Fitness, const FBreedingParams& Params, TArray<int32>& OutEliteRows, TArray<int32>& OutMatingPool);
+
+	// Fills OutNextGeneration with elites followed by mutated offspring
+	static void Breed(const FGenePool& Population, TConstArrayView<float> Fitness, const FBreedingParams& Params, FGenePool& OutNextGeneration);
+
+	// As above, but NSGA-II selection ranks the separate objectives instead of the weighted fitness
+	static void Breed(const FGenePool& Population, TConstArrayView<float> Fitness, const FFitnessObjectives& Objectives, const FBreedingParams& Params, FGenePool& OutNextGeneration);
+};
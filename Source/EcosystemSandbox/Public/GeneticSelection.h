@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SimulationRandom.h"
+#include "GeneticSelection.generated.h"
+
+UENUM(BlueprintType)
+enum class ESelectionStrategy : uint8
+{
+	Truncation			UMETA(DisplayName = "Truncation"),
+	Tournament			UMETA(DisplayName = "Tournament"),
+	StochasticUniversal	UMETA(DisplayName = "Stochastic Universal Sampling"),
+	NSGA2				UMETA(DisplayName = "NSGA-II (Multi-Objective)")
+};
+
+/**
+ * Linear-time parent selection over a fitness column.
+ * Every function works on row indices, so callers keep genes in whatever layout they like.
+ */
+struct ECOSYSTEMSANDBOX_API FGeneticSelection
+{
+	// Reorders Indices so the K fittest rows come first, in no particular order. Expected O(n).
+	static void PartitionTopK(TArrayView<int32> Indices, TConstArrayView<float> Fitness, int32 K);
+
+	// Returns the K fittest rows, best first. O(n + K log K).
+	static TArray<int32> SelectTopK(TConstArrayView<float> Fitness, int32 K);
+
+	// Builds a mating pool of Count rows using the given strategy
+	static void BuildMatingPool(ESelectionStrategy Strategy, TConstArrayView<float> Fitness, int32 Count, int32 TournamentSize, const FRandomStreamBatch& Streams, TArray<int32>& OutMatingPool);
+
+	// Each entry is the fittest of TournamentSize uniformly drawn rows. O(Count * TournamentSize).
+	static void Tournament(TConstArrayView<float> Fitness, int32 Count, int32 TournamentSize, const FRandomStreamBatch& Streams, TArray<int32>& OutMatingPool);
+
+	// Fitness-proportional picks with evenly spaced pointers and a single random offset. O(n + Count).
+	static void StochasticUniversalSampling(TConstArrayView<float> Fitness, int32 Count, FSimulationRandomStream& Stream, TArray<int32>& OutMatingPool);
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "CreatureGenetics.h"
+#include "CreatureLifeState.h"
+#include "CreatureMetabolism.h"
+#include "GenomeFitnessCache.generated.h"
+
+USTRUCT(BlueprintType)
+struct ECOSYSTEMSANDBOX_API FGenomeCacheStats
+{
+	GENERATED_BODY()
+
+	// Evaluations served from the cache
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Hits = 0;
+
+	// Evaluations that had to be computed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Misses = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Entries = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float HitRate = 0.0f;
+};
+
+/**
+ * Quantized genome hash. Continuous traits are mapped to 16 bits over their valid range, so genomes
+ * that differ by less than one step hash the same. Colors only change appearance and are ignored.
+ */
+struct ECOSYSTEMSANDBOX_API FGenomeHash
+{
+	static uint64 Hash(const FCreatureGenes& Genes);
+};
+
+// Everything derived from genes alone, fitness adds the life state terms on top
+struct FGenomeEvaluation
+{
+	float TraitFitness = 0.0f;
+	float SurvivalFitnessRate = 0.0f;
+	FCreatureMetabolismRates Rates;
+
+	static FGenomeEvaluation Evaluate(const FCreatureGenes& Genes)
+	{
+		FGenomeEvaluation Evaluation;
+		Evaluation.TraitFitness = Genes.CalculateTraitFitness();
+		Evaluation.SurvivalFitnessRate = Genes.GetSurvivalFitnessRate();
+		Evaluation.Rates = FCreatureMetabolism::DeriveRates(Genes);
+		return Evaluation;
+	}
+
+	// Same result as FCreatureGenes::CalculateRawFitness
+	float GetRawFitness(float Age, int32 OffspringCount, float ResourcesGathered, int32 CombatWins) const
+	{
+		return Age * SurvivalFitnessRate + FCreatureGenes::CalculateAchievementFitness(OffspringCount, ResourcesGathered, CombatWins) + TraitFitness;
+	}
+
+	float GetFitness(const FCreatureLifeState& State) const
+	{
+		return FMath::Max(0.0f, GetRawFitness(State.Age, State.OffspringCount, State.ResourcesGathered, State.CombatWins));
+	}
+};
+
+/**
+ * Least recently used cache of genome evaluations keyed by FGenomeHash. Elites and clones are
+ * evaluated once instead of every time they are spawned or bred. Not thread safe, give each
+ * thread its own cache.
+ */
+class ECOSYSTEMSANDBOX_API FGenomeFitnessCache
+{
+public:
+	explicit FGenomeFitnessCache(int32 Capacity = 4096);
+
+	// Empties the cache
+	void SetCapacity(int32 Capacity);
+
+	FGenomeEvaluation Evaluate(const FCreatureGenes& Genes);
+
+	FGenomeCacheStats GetStats() const;
+	void ResetStats();
+
+private:
+	TLruCache<uint64, FGenomeEvaluation> Entries;
+	int32 Hits = 0;
+	int32 Misses = 0;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureMetabolism.h"
+#include "CreatureHistoryLog.h"
+#include "GenomeFitnessCache.h"
+#include "GenePool.h"
+#include "GenerationBreeder.h"
+#include "NoveltyArchive.h"
+#include "QuantileSketch.h"
+#include "Speciation.h"
+
+struct FHeadlessEvolutionParams
+{
+	// Generation rules, same meaning as on AEcosystemManager
+	int32 MinPopulation = 10;
+	int32 MaxPopulation = 200;
+	float GenerationTimeLimit = 300.0f;
+
+	// Simulated seconds per step
+	float TimeStep = 0.25f;
+
+	// Stochastic stand-in for movement and perception: chance per second of meeting food,
+	// a mate or a rival, scaled by the traits that drive those encounters in the world
+	float FoodEncounterRate = 0.15f;
+	float FoodValue = 25.0f;
+	float MateEncounterRate = 0.2f;
+	float FightEncounterRate = 0.2f;
+
+	// PopulationSize, mutation, selection and seed, Generation is filled per generation
+	FBreedingParams Breeding;
+
+	FNoveltySearchParams Novelty;
+
+	FSpeciationParams Speciation;
+};
+
+struct FHeadlessGenerationStats
+{
+	int32 Generation = 0;
+	int32 Population = 0;
+	int32 Births = 0;
+	int32 Deaths = 0;
+	float AverageFitness = 0.0f;
+	float MaxFitness = 0.0f;
+	float SimulatedSeconds = 0.0f;
+	FCreatureGenes BestGenes;
+
+	// Everyone who lived this generation, the dead at their final fitness and survivors at the end
+	FPopulationSketch Sketch;
+
+	// Species of the survivors, empty when speciation is off
+	TArray<FSpeciesStats> Species;
+};
+
+/**
+ * Data-only evolution loop. Life cycles run on plain arrays through FCreatureMetabolism,
+ * the rules ACreature uses, while movement, perception and weather are replaced by
+ * random encounters. No actors or world are needed, so it runs from a commandlet.
+ */
+class ECOSYSTEMSANDBOX_API FHeadlessEvolution
+{
+public:
+	explicit FHeadlessEvolution(const FHeadlessEvolutionParams& InParams);
+
+	// Starts from a random population of Params.Breeding.PopulationSize
+	void InitializeRandom();
+	void Initialize(FGenePool&& InPopulation, int32 StartGeneration);
+
+	// Lives out the current generation, then breeds the next one
+	FHeadlessGenerationStats RunGeneration();
+
+	const FGenePool& GetPopulation() const { return Population; }
+	FGenePool& GetMutablePopulation() { return Population; }
+	int32 GetGeneration() const { return Generation; }
+
+	// Called for every creature that dies during a generation
+	TFunction<void(const FCreatureRecord&)> OnCreatureDeath;
+
+	const FGenomeFitnessCache& GetFitnessCache() const { return FitnessCache; }
+	const FNoveltyArchive& GetNoveltyArchive() const { return NoveltyArchive; }
+	const FSpeciation& GetSpeciation() const { return Speciation; }
+
+private:
+	void AddCreature(const FCreatureGenes& Genes);
+	void RemoveCreature(int32 Index, FHeadlessGenerationStats& Stats);
+
+	FHeadlessEvolutionParams Params;
+	FGenePool Population;
+	int32 Generation = 0;
+
+	// Live creatures of the generation being simulated
+	TArray<FCreatureGenes> Genes;
+	TArray<FCreatureLifeState> States;
+	TArray<FGenomeEvaluation> Evaluations;
+
+	// Elites and clones reappear every generation, owned per evolution so islands never share it
+	FGenomeFitnessCache FitnessCache;
+
+	// Genomes seen in earlier generations of this evolution, only filled when novelty search is enabled
+	FNoveltyArchive NoveltyArchive;
+
+	// Centroids carry over from one generation to the next
+	FSpeciation Speciation;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenePool.h"
+#include "GenerationBreeder.h"
+#include "GeneticSelection.h"
+#include "HeadlessEvolution.h"
+#include "IslandModel.generated.h"
+
+UENUM(BlueprintType)
+enum class EMigrationTopology : uint8
+{
+	Ring			UMETA(DisplayName = "Ring"),
+	FullyConnected	UMETA(DisplayName = "Fully Connected"),
+	Random			UMETA(DisplayName = "Random")
+};
+
+// Size and breeding settings of one sub-population
+USTRUCT(BlueprintType)
+struct ECOSYSTEMSANDBOX_API FIslandConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+	int32 PopulationSize = 25;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MutationRate = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MutationStrength = 0.2f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EMutationMode MutationMode = EMutationMode::Fixed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ElitePercentage = 0.2f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	ESelectionStrategy SelectionStrategy = ESelectionStrategy::Truncation;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+	int32 TournamentSize = 3;
+};
+
+struct FMigrationParams
+{
+	EMigrationTopology Topology = EMigrationTopology::Ring;
+
+	// Generations between migrations, 0 keeps the islands isolated
+	int32 Interval = 5;
+
+	// Genomes an island sends along each outgoing edge
+	int32 MigrantCount = 2;
+};
+
+/**
+ * Island model helpers. Every island breeds from its own gene pool with its own settings,
+ * and every few generations the best genomes of each island are copied to its neighbours.
+ */
+struct ECOSYSTEMSANDBOX_API FIslandModel
+{
+	// Island 0 keeps the run seed, so a single island reproduces a panmictic run
+	static uint64 GetIslandSeed(uint64 Seed, int32 Island);
+
+	static FBreedingParams MakeBreedingParams(const FIslandConfig& Config, uint64 Seed, int32 Island, int32 Generation);
+
+	static bool IsMigrationGeneration(const FMigrationParams& Params, int32 NumIslands, int32 Generation);
+
+	// Islands that Source sends migrants to
+	static void GetMigrationTargets(EMigrationTopology Topology, int32 NumIslands, int32 Source, FSimulationRandomStream& Stream, TArray<int32>& OutTargets);
+
+	// Copies the leading rows of each island, its elites, over the trailing offspring rows of its targets.
+	// All emigrants are taken before any island is written, and at most half of an island is replaced.
+	static void Migrate(TConstArrayView<FGenePool*> Islands, const FMigrationParams& Params, uint64 Seed, int32 Generation);
+
+	// Breeds every island in parallel, then migrates when Generation is a migration generation
+	static void BreedIslands(TConstArrayView<FGenePool> Populations, TConstArrayView<TArray<float>> Fitness, TConstArrayView<FFitnessObjectives> Objectives, TConstArrayView<FIslandConfig> Configs,
+		const FMigrationParams& Migration, uint64 Seed, int32 Generation, TArray<FGenePool>& OutNextGenerations);
+};
+
+/**
+ * Headless evolution of several islands, each a FHeadlessEvolution run on its own worker thread.
+ * Population limits in the base params are totals and are split by each island's share of the population.
+ */
+class ECOSYSTEMSANDBOX_API FIslandEvolution
+{
+public:
+	FIslandEvolution(const FHeadlessEvolutionParams& BaseParams, TConstArrayView<FIslandConfig> Configs, const FMigrationParams& InMigration);
+
+	void InitializeRandom();
+
+	// One gene pool per island
+	void Initialize(TArray<FGenePool>&& Populations, int32 StartGeneration);
+
+	// Lives out the current generation on every island, breeds and migrates. Returns totals over all islands.
+	FHeadlessGenerationStats RunGeneration();
+
+	int32 NumIslands() const { return Islands.Num(); }
+	const FGenePool& GetPopulation(int32 Island) const { return Islands[Island]->GetPopulation(); }
+	const FHeadlessGenerationStats& GetIslandStats(int32 Island) const { return IslandStats[Island]; }
+	int32 GetGeneration() const { return Islands.Num() > 0 ? Islands[0]->GetGeneration() : 0; }
+
+	// Archived genomes over all islands
+	int32 GetNoveltyArchiveSize() const;
+
+	// Fitness cache counters summed over the islands
+	FGenomeCacheStats GetFitnessCacheStats() const;
+
+	// Called on the calling thread for every creature that died, island by island
+	TFunction<void(const FCreatureRecord&)> OnCreatureDeath;
+
+private:
+	TArray<TUniquePtr<FHeadlessEvolution>> Islands;
+	TArray<FHeadlessGenerationStats> IslandStats;
+	TArray<TArray<FCreatureRecord>> IslandDeaths;
+	FMigrationParams Migration;
+	uint64 Seed = 0;
+};
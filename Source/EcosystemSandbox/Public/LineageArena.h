@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ChunkedArray.h"
+
+// Parentage of one creature, founders have no parents
+struct FLineageRecord
+{
+	uint32 Parent1;
+	uint32 Parent2;
+	int32 Generation;
+
+	// Simulated seconds at which the creature spawned
+	float BirthTime;
+};
+
+static_assert(sizeof(FLineageRecord) == 16, "Lineage records are stored in snapshots, bump FEcosystemSnapshotHeader::CurrentVersion");
+
+/**
+ * Parentage of every creature of a run. A creature's lineage id is the index of its record. Records are
+ * only appended, into fixed-size chunks, so an append is a 16-byte write that never moves earlier records.
+ * Parents are always appended before their offspring, so ids are in birth order and every walk towards
+ * the founders visits strictly decreasing ids.
+ */
+class ECOSYSTEMSANDBOX_API FLineageArena
+{
+public:
+	static constexpr uint32 InvalidId = MAX_uint32;
+
+	// Parents are InvalidId for a founder, or the same id twice for a clone such as a carried-over elite
+	uint32 Add(uint32 Parent1, uint32 Parent2, int32 Generation, float BirthTime);
+	uint32 AddFounder(int32 Generation, float BirthTime) { return Add(InvalidId, InvalidId, Generation, BirthTime); }
+
+	int32 Num() const { return Records.Num(); }
+	bool IsValidId(uint32 Id) const { return Id < static_cast<uint32>(Records.Num()); }
+	const FLineageRecord& Get(uint32 Id) const { return Records[Id]; }
+	bool IsFounder(uint32 Id) const { return Records[Id].Parent1 == InvalidId && Records[Id].Parent2 == InvalidId; }
+
+	// Ancestors up to MaxDepth parent links away, each once and nearest first, Id itself excluded
+	void GetAncestors(uint32 Id, int32 MaxDepth, TArray<uint32>& OutAncestors) const;
+
+	// Most recent ancestor shared by A and B, InvalidId when they have none. A creature counts as its own ancestor.
+	uint32 FindCommonAncestor(uint32 A, uint32 B) const;
+
+	// For every founder with a descendant among Ids, how many of Ids descend from it through either parent.
+	// A founder in Ids counts towards itself.
+	void CountDescendantsPerFounder(TConstArrayView<uint32> Ids, TMap<uint32, int32>& OutCounts) const;
+
+	void Reset();
+
+	// Snapshot support
+	void CopyTo(TArray<FLineageRecord>& OutRecords) const;
+	void Load(TConstArrayView<FLineageRecord> InRecords);
+
+private:
+	TChunkedArray<FLineageRecord, 64 * 1024> Records;
+};
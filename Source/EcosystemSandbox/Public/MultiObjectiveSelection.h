@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+#include "CreatureLifeState.h"
+
+// Components of the weighted fitness sum, each maximized on its own
+enum class EFitnessObjective : uint8
+{
+	Survival,
+	Offspring,
+	Resources,
+	CombatWins,
+	SizeEfficiency,
+	Intelligence,
+	Endurance,
+	Count
+};
+
+/**
+ * Objective values of a population, one contiguous column per objective like FGenePool.
+ */
+struct ECOSYSTEMSANDBOX_API FFitnessObjectives
+{
+	static constexpr int32 NumObjectives = static_cast<int32>(EFitnessObjective::Count);
+
+	TArray<float> Columns[NumObjectives];
+
+	int32 Num() const { return Columns[0].Num(); }
+
+	void Reset(int32 ExpectedNum = 0);
+
+	// Appends the unweighted terms of FCreatureGenes::CalculateRawFitness
+	void Add(const FCreatureGenes& Genes, const FCreatureLifeState& State);
+};
+
+/**
+ * NSGA-II ranking. Rows are sorted into non-dominated fronts with the efficient non-dominated
+ * sort (ENS-BS), then ordered within each front by crowding distance. Dominance against a whole
+ * front is one AND over a precomputed bit matrix, built in parallel, so 10k rows sort in tens of
+ * milliseconds on a single core instead of hundreds with pairwise checks.
+ */
+struct ECOSYSTEMSANDBOX_API FMultiObjectiveSelection
+{
+	// Front index of every row, 0 is the Pareto front. Returns the number of fronts.
+	static int32 SortFronts(const FFitnessObjectives& Objectives, TArray<int32>& OutFront);
+
+	// Crowding distance of every row within its front, boundary rows get the largest value
+	static void CrowdingDistance(const FFitnessObjectives& Objectives, TConstArrayView<int32> Front, int32 NumFronts, TArray<float>& OutDistance);
+
+	// One score per row that orders rows like the crowded-comparison operator: a better front always
+	// scores higher, and within a front a less crowded row scores higher. The existing top-K and
+	// tournament selection then act as NSGA-II elitism and crowded binary tournaments.
+	static void ComputeSelectionScores(const FFitnessObjectives& Objectives, TArray<float>& OutScores);
+};
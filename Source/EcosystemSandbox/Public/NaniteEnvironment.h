@@ -5,6 +5,7 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "GeometryCollection/GeometryCollectionComponent.h"
+#include "SimulationRandom.h"
 #include "NaniteEnvironment.generated.h"
 
 UENUM(BlueprintType)
@@ -123,6 +124,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment Configuration")
 	float TerrainDeformationStrength = 100.0f;
 
+	// Seed for foliage placement and destruction streams, the same seed reproduces the same layout
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment Configuration")
+	int32 RandomSeed = 0;
+
 	// Events
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FOnEnvironmentDestruction OnEnvironmentDestruction;
@@ -157,9 +162,9 @@ protected:
 	// Internal Functions
 	void SetupNaniteComponents();
 	void SetupFoliageComponents();
-	void SpawnFoliageInstance(const FNaniteFoliageConfig& Config, int32 ConfigIndex);
+	void SpawnFoliageInstance(const FNaniteFoliageConfig& Config, int32 ConfigIndex, int32 InstanceIndex);
 	void ConvertToDestructible(int32 InstanceIndex, const FNaniteFoliageConfig& Config);
-	FVector GetRandomPositionInRadius(float Radius) const;
+	FVector GetRandomPositionInRadius(float Radius, FSimulationRandomStream& Stream) const;
 	bool IsValidSpawnLocation(const FVector& Location) const;
 
 	UFUNCTION()
@@ -167,7 +172,7 @@ protected:
 
 private:
 	// Performance optimization
-	float LastRegrowthCheck = 0.0f;
+	double LastRegrowthCheck = 0.0;
 	float RegrowthCheckInterval = 5.0f;
 
 	// Cached references for performance
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenePool.h"
+
+struct FNoveltySearchParams
+{
+	// Share of the selection score taken by novelty, 0 disables novelty search and 1 ignores fitness
+	float Weight = 0.0f;
+
+	// Archived genomes averaged over for a genome's novelty
+	int32 NumNeighbors = 15;
+
+	// Most novel share of every generation added to the archive
+	float ArchiveFraction = 0.05f;
+
+	uint64 Seed = 0;
+
+	bool IsEnabled() const { return Weight > 0.0f; }
+};
+
+/**
+ * Archive of past genomes as trait vectors normalized to [0, 1]. The novelty of a genome is its mean
+ * distance to the k nearest archived genomes. Neighbours are found through random-projection LSH:
+ * a query only measures entries that share a bucket with it in one of the hash tables, and at most
+ * MaxBucketScan of the newest entries per bucket, so its cost stays flat as the archive grows.
+ */
+class ECOSYSTEMSANDBOX_API FNoveltyArchive
+{
+public:
+	static constexpr int32 NumTables = 8;
+
+	// Projections hashed together per table, more makes buckets smaller and neighbours easier to miss
+	static constexpr int32 NumProjections = 6;
+
+	// Width of a bucket along each projection, in normalized trait units
+	static constexpr float BucketWidth = 1.0f;
+
+	// Dense regions have low novelty anyway, so crowded buckets are only sampled
+	static constexpr int32 MaxBucketScan = 256;
+
+	explicit FNoveltyArchive(const FNoveltySearchParams& InParams);
+
+	// Projections keep the seed the archive was created with
+	void SetParams(const FNoveltySearchParams& InParams) { Params = InParams; }
+
+	// Writes the NumTraits traits of a row scaled to [0, 1] by their clamp ranges
+	static void Normalize(const FGenePool& Pool, int32 Row, float* OutTraits);
+
+	// Distance reported for neighbours that were not found, the diagonal of the unit trait cube
+	static float GetMaxDistance();
+
+	void Add(const float* Traits);
+
+	// Mean distance to the NumNeighbors nearest archived genomes. Safe to call from several threads.
+	float GetNovelty(const float* Traits) const;
+
+	// Novelty of every row, rows are scored in parallel
+	void ComputeNovelty(const FGenePool& Population, TArray<float>& OutNovelty) const;
+
+	// Blends novelty into Fitness by Weight, then archives the most novel rows
+	void ScoreAndArchive(const FGenePool& Population, TArray<float>& InOutFitness);
+
+	int32 Num() const { return Points.Num() / FGenePool::NumTraits; }
+	void Reset();
+
+private:
+	uint64 GetBucketKey(int32 Table, const float* Traits) const;
+
+	FNoveltySearchParams Params;
+
+	// Row-major normalized traits, one row per archived genome
+	TArray<float> Points;
+
+	// Gaussian directions and uniform offsets, NumProjections per table
+	TArray<float> Directions;
+	TArray<float> Offsets;
+
+	TMap<uint64, TArray<int32>> Buckets[NumTables];
+};
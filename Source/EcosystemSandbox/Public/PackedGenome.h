@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+#include "GenePool.h"
+#include "PackedGenome.generated.h"
+
+/**
+ * Compact genome for storage and transfer, 32 bytes instead of the 84 of FCreatureGenes.
+ * Continuous traits are 16-bit fixed point over their ClampMin/ClampMax range, the two enums
+ * share a byte, the mutation step size is an 8-bit logarithm and colors are linear RGBA8. Unpacking is exact to within half a quantization
+ * step for in-range values, out-of-range values are clamped.
+ */
+USTRUCT()
+struct ECOSYSTEMSANDBOX_API FPackedGenome
+{
+	GENERATED_BODY()
+
+	static constexpr uint8 EnumBits = 3;
+	static constexpr uint8 EnumMask = (1 << EnumBits) - 1;
+
+	UPROPERTY()
+	uint16 Traits[FGenePool::NumTraits] = {};
+
+	// MovementType in the low bits, AggressionLevel above it
+	UPROPERTY()
+	uint8 Enums = 0;
+
+	// MutationStepSize on a log scale from MinStepSize to MaxStepSize
+	UPROPERTY()
+	uint8 StepSize = 0;
+
+	UPROPERTY()
+	FColor PrimaryColor = FColor::White;
+
+	UPROPERTY()
+	FColor SecondaryColor = FColor::White;
+
+	static FPackedGenome Pack(const FCreatureGenes& Genes);
+	FCreatureGenes Unpack() const;
+
+	EMovementType GetMovementType() const { return static_cast<EMovementType>(Enums & EnumMask); }
+	EAggressionLevel GetAggressionLevel() const { return static_cast<EAggressionLevel>((Enums >> EnumBits) & EnumMask); }
+
+	static uint16 QuantizeTrait(EGeneTrait Trait, float Value);
+	static float DequantizeTrait(EGeneTrait Trait, uint16 Quantized);
+
+	static uint8 QuantizeStepSize(float Value);
+	static float DequantizeStepSize(uint8 Quantized);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	friend FArchive& operator<<(FArchive& Ar, FPackedGenome& Genome);
+
+	bool operator==(const FPackedGenome& Other) const
+	{
+		return FMemory::Memcmp(this, &Other, sizeof(FPackedGenome)) == 0;
+	}
+};
+
+static_assert(sizeof(FPackedGenome) == 32, "Packed genome layout changed, bump the history log and snapshot versions");
+static_assert(static_cast<int32>(EMovementType::Count) <= (1 << FPackedGenome::EnumBits) && static_cast<int32>(EAggressionLevel::Count) <= (1 << FPackedGenome::EnumBits), "Enum no longer fits in FPackedGenome::EnumBits");
+
+template<>
+struct TStructOpsTypeTraits<FPackedGenome> : public TStructOpsTypeTraitsBase2<FPackedGenome>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+
+class ACreature;
+
+/**
+ * Running population aggregates, updated on spawn, death and fitness events instead of rescanning every creature.
+ *
+ * Between events a creature's fitness only changes through aging, which is linear in time,
+ * so each creature is stored as Fitness(t) = Max(0, Base + Rate * t). Sums of those lines are
+ * kept in closed form. Creatures whose line is still below zero sit in an activation heap and
+ * join the sums when they cross it. The fittest creature is tracked kinetically: a full pass
+ * over the flat Base/Rate arrays only happens when the leader leaves or may have been overtaken.
+ */
+struct ECOSYSTEMSANDBOX_API FPopulationAggregates
+{
+	void Reset();
+
+	// Fitness is the unclamped score, FitnessRate its growth per second from aging
+	void Add(ACreature* Creature, float Fitness, float FitnessRate, EMovementType MovementType, EAggressionLevel AggressionLevel, double Now);
+	void Remove(const ACreature* Creature);
+
+	// Re-anchors a creature after an event that changed its fitness
+	void UpdateFitness(const ACreature* Creature, float Fitness, double Now);
+
+	int32 Num() const { return Creatures.Num(); }
+	double GetTotalFitness(double Now);
+
+	// Fittest creature at Now, nullptr when empty
+	ACreature* FindLeader(double Now, float& OutFitness);
+
+	int32 GetMovementTypeCount(EMovementType Type) const { return MovementTypeCounts[static_cast<int32>(Type)]; }
+	int32 GetAggressionLevelCount(EAggressionLevel Level) const { return AggressionLevelCounts[static_cast<int32>(Level)]; }
+
+	// Number of full leader rescans, useful for profiling
+	int32 GetLeaderRescanCount() const { return LeaderRescanCount; }
+
+private:
+	struct FActivation
+	{
+		double Time;
+		int32 Slot;
+		uint32 Version;
+
+		bool operator<(const FActivation& Other) const { return Time < Other.Time; }
+	};
+
+	void Activate(int32 Slot);
+	void Deactivate(int32 Slot);
+	void ProcessActivations(double Now);
+	void AnchorSlot(int32 Slot, float Fitness, double Now);
+	void ConsiderLeader(int32 Slot, double Now);
+	void RescanLeader(double Now);
+	double Evaluate(int32 Slot, double Now) const { return Base[Slot] + Rate[Slot] * Now; }
+
+	// Slot columns
+	TArray<ACreature*> Creatures;
+	TArray<double> Base;
+	TArray<double> Rate;
+	TArray<uint8> bActive;
+	TArray<uint32> Versions;
+	uint32 VersionCounter = 0;
+	TArray<uint8> MovementTypes;
+	TArray<uint8> AggressionLevels;
+
+	TMap<const ACreature*, int32> SlotLookup;
+
+	// Sums over creatures with positive fitness
+	double ActiveBaseSum = 0.0;
+	double ActiveRateSum = 0.0;
+	TArray<FActivation> ActivationHeap;
+
+	// Kinetic leader
+	int32 LeaderSlot = INDEX_NONE;
+	double NextLeaderCheckTime = 0.0;
+	bool bLeaderDirty = true;
+	int32 LeaderRescanCount = 0;
+
+	int32 MovementTypeCounts[static_cast<int32>(EMovementType::Count)] = {};
+	int32 AggressionLevelCounts[static_cast<int32>(EAggressionLevel::Count)] = {};
+};
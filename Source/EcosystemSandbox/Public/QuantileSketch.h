@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CreatureGenetics.h"
+#include "GenePool.h"
+#include "QuantileSketch.generated.h"
+
+USTRUCT(BlueprintType)
+struct ECOSYSTEMSANDBOX_API FQuantileSummary
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Count = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float Min = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float P10 = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float P25 = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float Median = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float P75 = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float P90 = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float Max = 0.0f;
+};
+
+USTRUCT(BlueprintType)
+struct ECOSYSTEMSANDBOX_API FGenerationQuantiles
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Generation = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FQuantileSummary Fitness;
+
+	// Indexed by EGeneTrait
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FQuantileSummary> Traits;
+};
+
+/**
+ * KLL streaming quantile sketch. Values go into a stack of compactors, level h holding values
+ * of weight 2^h. A full level is sorted and every other value, starting at a random offset,
+ * moves up a level, so memory stays near 3K values however many are added and an Add costs
+ * O(1) amortized. Sketches merge level by level, so they can be filled on separate threads
+ * or islands and combined. With the default K the rank error is around 1%.
+ */
+class ECOSYSTEMSANDBOX_API FKllSketch
+{
+public:
+	static constexpr int32 DefaultK = 200;
+
+	explicit FKllSketch(int32 InK = DefaultK);
+
+	void Add(float Value);
+	void Merge(const FKllSketch& Other);
+	void Reset();
+
+	int64 Num() const { return Count; }
+	float GetMin() const { return Min; }
+	float GetMax() const { return Max; }
+
+	// Value at each normalized rank in [0, 1], Fractions ascending
+	void GetQuantiles(TConstArrayView<float> Fractions, TArrayView<float> OutValues) const;
+	float GetQuantile(float Fraction) const;
+
+	// Estimated share of added values at or below Value
+	float GetRank(float Value) const;
+
+	FQuantileSummary GetSummary() const;
+
+private:
+	int32 GetCapacity(int32 Level) const;
+	void AddLevel();
+	void Compress();
+
+	int32 K;
+	TArray<TArray<float>> Levels;
+
+	// Values held over all levels, compression starts once it reaches MaxSize
+	int32 Size = 0;
+	int32 MaxSize = 0;
+
+	int64 Count = 0;
+	float Min = 0.0f;
+	float Max = 0.0f;
+
+	// Picks the offset of every compaction
+	uint64 CompactionCounter = 0;
+};
+
+// Fitness and every continuous trait of a population
+struct ECOSYSTEMSANDBOX_API FPopulationSketch
+{
+	FKllSketch Fitness;
+	FKllSketch Traits[FGeneTraits::Num];
+
+	void Add(const FCreatureGenes& Genes, float CreatureFitness);
+	void Add(const FGenePool& Pool, int32 Row, float CreatureFitness);
+	void Merge(const FPopulationSketch& Other);
+	void Reset();
+
+	FGenerationQuantiles GetQuantiles(int32 Generation) const;
+};
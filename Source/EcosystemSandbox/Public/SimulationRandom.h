@@ -0,0 +1,164 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Keeps streams that share a seed, id and generation independent from each other
+enum class ERandomStreamPurpose : uint32
+{
+	Genesis,
+	Selection,
+	MatingPool,
+	Crossover,
+	Mutation,
+	Spawn,
+	Creature,
+	Foliage,
+	Destruction,
+	Island,
+	Migration,
+	Novelty,
+	Speciation
+};
+
+/**
+ * Counter-based random stream.
+ * Every draw is a pure hash of (Seed, StreamId, Generation, Purpose, Counter), so a stream can be
+ * recreated on any thread and results never depend on how work was scheduled. Unlike FMath::Rand
+ * there is no shared generator state, which makes streams safe to use from parallel jobs.
+ */
+struct FSimulationRandomStream
+{
+	FSimulationRandomStream() = default;
+
+	FSimulationRandomStream(uint64 Seed, uint32 StreamId, uint32 Generation, ERandomStreamPurpose Purpose)
+		: Key(MakeKey(Seed, StreamId, Generation, Purpose))
+	{
+	}
+
+	uint32 GetUnsignedInt()
+	{
+		return Hash(Key, Counter++);
+	}
+
+	// Uniform in [0, 1)
+	float GetFraction()
+	{
+		return ToFraction(GetUnsignedInt());
+	}
+
+	float FRandRange(float Min, float Max)
+	{
+		return Min + (Max - Min) * GetFraction();
+	}
+
+	// Uniform in [Min, Max], inclusive like FMath::RandRange
+	int32 RandRange(int32 Min, int32 Max)
+	{
+		const int64 Range = static_cast<int64>(Max) - Min + 1;
+		return Range > 0 ? Min + static_cast<int32>((static_cast<uint64>(GetUnsignedInt()) * static_cast<uint64>(Range)) >> 32) : Min;
+	}
+
+	// Standard normal
+	float GetGaussian()
+	{
+		const uint32 BitsA = GetUnsignedInt();
+		const uint32 BitsB = GetUnsignedInt();
+		return ToGaussian(BitsA, BitsB);
+	}
+
+	// Same distribution as FLinearColor::MakeRandomColor
+	FLinearColor MakeRandomColor()
+	{
+		return FLinearColor::MakeFromHSV8(static_cast<uint8>(GetFraction() * 255.0f), 255, 255);
+	}
+
+	uint64 GetKey() const { return Key; }
+	uint32 GetCounter() const { return Counter; }
+	void SetCounter(uint32 NewCounter) { Counter = NewCounter; }
+
+	// Recreates a stream from a saved key and counter
+	static FSimulationRandomStream FromState(uint64 StreamKey, uint32 StreamCounter)
+	{
+		FSimulationRandomStream Stream;
+		Stream.Key = StreamKey;
+		Stream.Counter = StreamCounter;
+		return Stream;
+	}
+
+	// SplitMix64 finalizer
+	static FORCEINLINE uint64 Mix(uint64 Value)
+	{
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	static FORCEINLINE uint64 MakeKey(uint64 Seed, uint32 StreamId, uint32 Generation, ERandomStreamPurpose Purpose)
+	{
+		const uint64 Id = (static_cast<uint64>(Generation) << 32) | StreamId;
+		return Mix(Mix(Seed ^ (static_cast<uint64>(Purpose) * 0xD6E8FEB86659FD93ull)) ^ Id);
+	}
+
+	// Stateless draw, used directly by batched kernels
+	static FORCEINLINE uint32 Hash(uint64 StreamKey, uint32 DrawIndex)
+	{
+		return static_cast<uint32>(Mix(StreamKey + (static_cast<uint64>(DrawIndex) + 1) * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+
+	static FORCEINLINE float ToFraction(uint32 Bits)
+	{
+		return static_cast<float>(Bits >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Box-Muller over two draws, the first is offset by half a step so the log stays finite
+	static FORCEINLINE float ToGaussian(uint32 BitsA, uint32 BitsB)
+	{
+		const float Radius = FMath::Sqrt(-2.0f * FMath::Loge((static_cast<float>(BitsA >> 8) + 0.5f) * (1.0f / 16777216.0f)));
+		return Radius * FMath::Cos(UE_TWO_PI * ToFraction(BitsB));
+	}
+
+private:
+	uint64 Key = 0;
+	uint32 Counter = 0;
+};
+
+/**
+ * A contiguous range of streams, one per batch row: row i draws from stream FirstStreamId + i.
+ */
+struct FRandomStreamBatch
+{
+	uint64 Seed = 0;
+	uint32 Generation = 0;
+	uint32 FirstStreamId = 0;
+	ERandomStreamPurpose Purpose = ERandomStreamPurpose::Genesis;
+
+	FRandomStreamBatch() = default;
+
+	FRandomStreamBatch(uint64 InSeed, uint32 InGeneration, uint32 InFirstStreamId, ERandomStreamPurpose InPurpose)
+		: Seed(InSeed)
+		, Generation(InGeneration)
+		, FirstStreamId(InFirstStreamId)
+		, Purpose(InPurpose)
+	{
+	}
+
+	FRandomStreamBatch WithPurpose(ERandomStreamPurpose NewPurpose) const
+	{
+		return FRandomStreamBatch(Seed, Generation, FirstStreamId, NewPurpose);
+	}
+
+	FRandomStreamBatch Offset(int32 Rows) const
+	{
+		return FRandomStreamBatch(Seed, Generation, FirstStreamId + Rows, Purpose);
+	}
+
+	uint64 GetKey(int32 Row) const
+	{
+		return FSimulationRandomStream::MakeKey(Seed, FirstStreamId + Row, Generation, Purpose);
+	}
+
+	FSimulationRandomStream GetStream(int32 Row) const
+	{
+		return FSimulationRandomStream(Seed, FirstStreamId + Row, Generation, Purpose);
+	}
+};
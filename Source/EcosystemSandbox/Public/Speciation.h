@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenePool.h"
+#include "Speciation.generated.h"
+
+struct FSpeciationParams
+{
+	// Clusters per population, 0 disables speciation
+	int32 NumSpecies = 0;
+
+	// Divides fitness by species size before selection
+	bool bFitnessSharing = true;
+
+	// Lloyd iterations per generation, clustering stops earlier once no genome changes species
+	int32 MaxIterations = 10;
+
+	uint64 Seed = 0;
+
+	bool IsEnabled() const { return NumSpecies > 0; }
+};
+
+USTRUCT(BlueprintType)
+struct ECOSYSTEMSANDBOX_API FSpeciesStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Island = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Species = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Size = 0;
+
+	// Raw fitness, before sharing
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float AverageFitness = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float MaxFitness = 0.0f;
+
+	// Lineage ids of the members, see AEcosystemManager::GetLineage. Empty for gene pools without lineage.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<int32> Members;
+};
+
+/**
+ * Splits a population into species by k-means over trait vectors normalized to [0, 1]. Traits are
+ * normalized into columns and every centroid is measured against a block of rows at a time, so the
+ * inner loops run over contiguous floats and vectorize. Centroids carry over between generations,
+ * which keeps species indices stable and usually converges in a few iterations.
+ */
+class ECOSYSTEMSANDBOX_API FSpeciation
+{
+public:
+	// Rows assigned per task
+	static constexpr int32 BlockSize = 1024;
+
+	explicit FSpeciation(const FSpeciationParams& InParams);
+
+	// Centroids are reseeded when the number of species changes
+	void SetParams(const FSpeciationParams& InParams) { Params = InParams; }
+
+	// Assigns every row of Population a species
+	void Cluster(const FGenePool& Population);
+
+	// Clusters, records species stats from the raw fitness, then applies fitness sharing if enabled
+	void ClusterAndShare(const FGenePool& Population, TArray<float>& InOutFitness);
+
+	// Species of every row of the last clustered population
+	const TArray<int32>& GetSpecies() const { return Species; }
+
+	// One entry per species of the last ClusterAndShare, Island left at 0
+	const TArray<FSpeciesStats>& GetStats() const { return Stats; }
+
+	int32 GetNumSpecies() const { return Centroids.Num() / FGenePool::NumTraits; }
+
+	void Reset();
+
+private:
+	void SeedCentroids(int32 NumRows, int32 NumSpecies);
+
+	// Returns the number of rows that changed species
+	int32 Assign(int32 NumRows);
+	void UpdateCentroids(int32 NumRows);
+
+	FSpeciationParams Params;
+
+	// Normalized traits, one column of NumRows per trait
+	TArray<float> Columns;
+
+	// Row-major, NumTraits per species
+	TArray<float> Centroids;
+
+	TArray<int32> Species;
+
+	// Squared distance of every row to its centroid
+	TArray<float> Distances;
+
+	TArray<FSpeciesStats> Stats;
+
+	// Each seeding draws from its own stream
+	uint32 NumSeedings = 0;
+};